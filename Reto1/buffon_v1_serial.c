@@ -16,22 +16,28 @@ int main(int argc, char** argv){
     const char* outfile = argv[3];
 
     const double L = 1.0, D = 1.0;
+    // seno: HPC_BUFFON_SIN=poly (defecto) | libm | reject
+    int mode = mc_sin_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_BUFFON_SIN desconocido (poly|libm|reject)\n");
+        return 1;
+    }
 
-    rng64_t rng = { .s = 0x243f6a8885a308d3ULL };
-    long long crosses = 0;
 
     double t0 = sec_now();
-    for (long long i = 0; i < N; ++i){
-        double theta = M_PI * rand01(&rng);   // θ ~ U[0, π)
-        double y     = (D * 0.5) * rand01(&rng); // y ~ U[0, D/2)
-        if (0.5 * L * fabs(sin(theta)) >= y) crosses++;
-    }
+    // volatile: sin HPC_MC_COUNT el conteo no se imprime y -O3 podría eliminar el cómputo
+    uint64_t needles = 0;
+    volatile long long crosses = (long long)mc_buffon_count_stream(BUFFON_SEED, 0, (uint64_t)N, L, D,
+                                                                   mode, &needles);
     double t1 = sec_now();
     double elapsed = t1 - t0;
 
     FILE *f = fopen(outfile, "a");
     if (f) {
-        fprintf(f, "N=%lld %.6f\n", N, elapsed);
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (mc_count_enabled()) fprintf(f, " count=%lld", (long long)crosses);
+        if (mc_count_enabled() && mode == MC_SIN_REJECT) fprintf(f, " needles=%lld", (long long)needles);
+        fprintf(f, "\n");
         fclose(f);
     } else {
         perror("fopen");
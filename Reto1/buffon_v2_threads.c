@@ -6,30 +6,26 @@
 #include <string.h>
 #include <math.h>
 #include "common.h"
+#include "../common/affinity.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 typedef struct {
-    long long a, b;     // rango [a,b)
-    uint64_t seed;      // semilla por hilo
+    uint64_t seed;      // semilla del flujo (común a todos los hilos)
     double L, D;        // parámetros de Buffon (aquí L=D=1.0)
-    long long local_cross;
-} task_t;
+    int mode;           // MC_SIN_*
+} buffon_ctx_t;
 
-static void* worker(void* arg){
-    task_t* t = (task_t*)arg;
-    rng64_t rng = {.s = t->seed};
-    long long cross = 0;
-    for (long long i = t->a; i < t->b; ++i){
-        (void)i;
-        double theta = M_PI * rand01(&rng);   // θ ~ U[0,π)
-        double y     = (t->D * 0.5) * rand01(&rng); // y ~ U[0,D/2)
-        if (0.5 * t->L * fabs(sin(theta)) >= y) cross++;
-    }
-    t->local_cross = cross;
-    return NULL;
+// Un trozo [a,b) del flujo: acc[0] cruces, acc[1] agujas (< b-a solo en modo reject)
+static void buffon_body(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], void* ctx){
+    const buffon_ctx_t* c = (const buffon_ctx_t*)ctx;
+    acc[0] += mc_buffon_count_stream(c->seed, a, b, c->L, c->D, c->mode, &acc[1]);
+}
+
+static void pin(int id, void* aff){
+    affinity_pin_thread((const affinity_t*)aff, id);
 }
 
 int main(int argc, char** argv){
@@ -44,45 +40,51 @@ int main(int argc, char** argv){
 
     // Parámetros clásicos
     const double L = 1.0, D = 1.0;
-
-    pthread_t* th   = (pthread_t*)malloc(T*sizeof(*th));
-    task_t*    tasks= (task_t*)calloc(T, sizeof(*tasks));
-
-    long long chunk = N / T, rem = N % T;
-
-    // Preparar tareas y CREAR hilos
-    for (int i=0;i<T;i++){
-        long long a = i*chunk + (i<rem? i : rem);
-        long long b = a + chunk + (i<rem?1:0);
-        tasks[i].a = a; tasks[i].b = b;
-        tasks[i].seed = 0x243f6a8885a308d3ULL ^ (uint64_t)(i+1);
-        tasks[i].L = L; tasks[i].D = D;
-        tasks[i].local_cross = 0;
-        pthread_create(&th[i], NULL, worker, &tasks[i]);
+    // seno: HPC_BUFFON_SIN=poly (defecto) | libm | reject
+    int mode = mc_sin_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_BUFFON_SIN desconocido (poly|libm|reject)\n");
+        return 1;
     }
 
-    // Medición SOLO del cómputo
-    double t0 = sec_now();
+    // Afinidad opcional (HPC_AFFINITY=compact|scatter|cores|list:...)
+    affinity_t aff;
+    affinity_from_env(&aff, T);
 
-    long long total = 0;
-    for (int i=0;i<T;i++){
-        pthread_join(th[i], NULL);
-        total += tasks[i].local_cross;
+    // Pool: hilos creados, fijados y esperando antes de medir
+    rt_pool_t pool;
+    if (rt_pool_init(&pool, T, pin, &aff) != 0){
+        fprintf(stderr, "no se pudieron crear %d hilos\n", T);
+        affinity_release(&aff);
+        return 1;
     }
+    buffon_ctx_t ctx = { BUFFON_SEED, L, D, mode };
 
+    // Medir la región paralela completa: soltar hilos, trozos dinámicos, esperar a todos
+    uint64_t acc[RT_NACC];
+    double t0 = sec_now();
+    rt_parallel_reduce(&pool, (uint64_t)N, RT_CHUNK, buffon_body, &ctx, acc);
     double t1 = sec_now();
     double elapsed = t1 - t0;
+    rt_pool_destroy(&pool);
+    long long total = (long long)acc[0], needles = (long long)acc[1];
 
     FILE *f = fopen(outfile, "a");
     if (f) {
-        fprintf(f, "N=%lld %.6f\n", N, elapsed);
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (aff.enabled) {
+            char buf[512];
+            fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+        }
+        if (mc_count_enabled()) fprintf(f, " count=%lld", total);
+        if (mc_count_enabled() && mode == MC_SIN_REJECT) fprintf(f, " needles=%lld", needles);
+        fprintf(f, "\n");
         fclose(f);
     } else {
         perror("fopen");
-        free(th); free(tasks);
+        affinity_release(&aff);
         return 2;
     }
-
-    free(th); free(tasks);
+    affinity_release(&aff);
     return 0;
 }
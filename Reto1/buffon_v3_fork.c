@@ -3,93 +3,92 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <sys/wait.h>
-#include <sys/mman.h>
 #include <string.h>
 #include <math.h>
 #include "common.h"
+#include "fork_rt.h"      // pool pre-forkeado: barrera futex + slots compartidos
+#include "../common/affinity.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+typedef struct {
+    uint64_t seed;      // semilla del flujo (común a todos los hijos)
+    double L, D;        // parámetros de Buffon (aquí L=D=1.0)
+    int mode;           // MC_SIN_*
+} buffon_ctx_t;
+
+// acc[0] cruces, acc[1] agujas lanzadas (< b-a solo en modo reject)
+static void buffon_body(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], const void* ctx){
+    const buffon_ctx_t* c = (const buffon_ctx_t*)ctx;
+    acc[0] += mc_buffon_count_stream(c->seed, a, b, c->L, c->D, c->mode, &acc[1]);
+}
+
+static void pin(int i, void* aff){
+    affinity_pin_process((const affinity_t*)aff, i);
+}
+
 int main(int argc, char** argv){
     if (argc < 4){
-        fprintf(stderr, "Uso: %s N P outfile\n", argv[0]);
+        fprintf(stderr, "Uso: %s N[,N2,...] P outfile\n", argv[0]);
         return 1;
     }
-    long long N = atoll(argv[1]);
     int P = atoi(argv[2]);
     const char* outfile = argv[3];
     if (P <= 0) P = 1;
 
     // Parámetros clásicos
     const double L = 1.0, D = 1.0;
-
-    int (*pipes)[2] = malloc((size_t)P * sizeof *pipes);
-    if (!pipes){ perror("malloc"); return 2; }
-
-    volatile int* start = mmap(NULL, sizeof(int),
-                               PROT_READ | PROT_WRITE,
-                               MAP_SHARED | MAP_ANON, -1, 0);
-    if (start == MAP_FAILED){ perror("mmap"); free(pipes); return 2; }
-    *start = 0;
-
-    long long chunk = N / P, rem = N % P;
-
-    for (int i=0;i<P;i++){
-        if (pipe(pipes[i]) != 0){ perror("pipe"); return 2; }
-        pid_t pid = fork();
-        if (pid < 0){ perror("fork"); return 2; }
-        if (pid == 0){
-            // --- Hijo ---
-            close(pipes[i][0]);
-            while (!*start) { /* spin */ }
-            __sync_synchronize();
-
-            long long a = i*chunk + (i<rem? i : rem);
-            long long b = a + chunk + (i<rem?1:0);
-
-            rng64_t rng = { .s = 0x243f6a8885a308d3ULL ^ (uint64_t)(i+1) };
-
-            long long cross = 0;
-            for (long long k = a; k < b; ++k){
-                (void)k;
-                double theta = M_PI * rand01(&rng);
-                double y     = (D * 0.5) * rand01(&rng);
-                if (0.5 * L * fabs(sin(theta)) >= y) cross++;
-            }
-            if (write(pipes[i][1], &cross, sizeof(cross)) != sizeof(cross)) { /* ignore */ }
-            close(pipes[i][1]);
-            _exit(0);
-        } else {
-            // Padre
-            close(pipes[i][1]);
-        }
+    // seno: HPC_BUFFON_SIN=poly (defecto) | libm | reject
+    int mode = mc_sin_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_BUFFON_SIN desconocido (poly|libm|reject)\n");
+        return 1;
     }
 
-    // levantar barrera y arrancar cronómetro (cómputo puro)
-    __sync_synchronize();
-    *(int*)start = 1;
-    __sync_synchronize();
-
-    double t0 = sec_now();
-
-    long long total = 0, tmp = 0; int status = 0;
-    for (int i=0;i<P;i++){
-        if (read(pipes[i][0], &tmp, sizeof(tmp)) == sizeof(tmp)) total += tmp;
-        close(pipes[i][0]);
-        wait(&status);
+    // Afinidad opcional (HPC_AFFINITY=compact|scatter|cores|list:...)
+    affinity_t aff;
+    affinity_from_env(&aff, P);
+
+    // Hijos creados una vez y dormidos en la barrera antes de medir
+    buffon_ctx_t ctx = { BUFFON_SEED, L, D, mode };
+    fk_pool_t pool;
+    if (fk_pool_init(&pool, P, buffon_body, &ctx, pin, &aff) != 0){
+        perror("fork");
+        affinity_release(&aff);
+        return 2;
     }
 
-    double t1 = sec_now();
-    double elapsed = t1 - t0;
-
+    // N puede ser una lista "100000000,500000000,...": el mismo pool para todos,
+    // una línea de salida por N
     FILE *f = fopen(outfile, "a");
-    if (f) { fprintf(f, "N=%lld %.6f\n", N, elapsed); fclose(f); }
-    else { perror("fopen"); }
+    if (!f){ perror("fopen"); fk_pool_destroy(&pool); affinity_release(&aff); return 2; }
+    for (const char* s = argv[1]; *s; ){
+        char* end;
+        long long N = strtoll(s, &end, 10);
+        if (end == s) break;
+        s = (*end == ',') ? end + 1 : end;
+
+        uint64_t acc[RT_NACC];
+        double t0 = sec_now();
+        fk_pool_run(&pool, (uint64_t)N, acc);
+        double t1 = sec_now();
+        double elapsed = t1 - t0;
+        long long total = (long long)acc[0], needles = (long long)acc[1];
+
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (aff.enabled) {
+            char buf[512];
+            fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+        }
+        if (mc_count_enabled()) fprintf(f, " count=%lld", total);
+        if (mc_count_enabled() && mode == MC_SIN_REJECT) fprintf(f, " needles=%lld", needles);
+        fprintf(f, "\n");
+    }
+    fclose(f);
 
-    munmap((void*)start, sizeof(int));
-    free(pipes);
+    fk_pool_destroy(&pool);
+    affinity_release(&aff);
     return 0;
 }
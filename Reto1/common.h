@@ -1,6 +1,11 @@
 #pragma once
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../common/mc_kernels.h"   // generador de 8 carriles + kernels por bloques
 
 typedef struct { uint64_t s; } rng64_t;
 
@@ -15,7 +20,210 @@ static inline double rand01(rng64_t* st) {
     return (xorshift64s(st) >> 11) * (1.0/9007199254740992.0);
 }
 
+// Semillas de los flujos reproducibles (../common/rng_stream.h): las mismas en
+// serial, hilos y fork, así el conteo no depende de T ni del backend
+#define DART_SEED   0x9e3779b97f4a7c15ULL
+#define BUFFON_SEED 0x243f6a8885a308d3ULL
+
+// HPC_MC_COUNT=1: los programas añaden " count=<aciertos>" a su línea de salida
+// (para comparar bit a bit una corrida paralela contra la serial)
+static inline int mc_count_enabled(void) {
+    const char *e = getenv("HPC_MC_COUNT");
+    return e && e[0] == '1';
+}
+
 static inline double sec_now(){
     struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
     return ts.tv_sec + ts.tv_nsec*1e-9;
 }
+
+// ---- runtime de hilos: pool persistente + parallel_reduce ----
+//
+// Los hilos se crean y se fijan (on_start, p. ej. afinidad) UNA vez en
+// rt_pool_init, que no vuelve hasta que todos están listos y esperando. Cada
+// rt_pool_run los suelta a la vez (barrera de inicio: un solo broadcast), el
+// hilo que llama trabaja como id 0 y espera a que terminen todos. Así el
+// tiempo medido alrededor de rt_pool_run / rt_parallel_reduce es la región
+// paralela completa: ni creación de hilos ni hilos que ya arrancaron antes.
+//
+// rt_parallel_reduce reparte [0,n) en trozos de `chunk` muestras reclamados
+// con un fetch_add atómico (reparto dinámico: un hilo lento no retiene a los
+// demás). Cada hilo acumula en su propio rt_partial_t, alineado y rellenado a
+// una línea de caché (sin false sharing); al final se suman los parciales.
+// Con chunk múltiplo de MC_STREAM_BLOCK y kernels *_count_stream el total es
+// el mismo para cualquier T y cualquier orden de reclamo.
+//
+// Uso:
+//   static void body(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], void *ctx) {
+//       acc[0] += mc_dart_count_stream(seed, a, b, mode);
+//   }
+//   rt_pool_t pool;
+//   if (rt_pool_init(&pool, T, on_start, ctx) != 0) ...error...
+//   uint64_t acc[RT_NACC];
+//   rt_parallel_reduce(&pool, N, RT_CHUNK, body, ctx, acc);
+//   rt_pool_destroy(&pool);
+
+#define RT_CACHELINE 64
+#define RT_NACC      2                          // acumuladores por hilo (p. ej. cruces, agujas)
+#define RT_CHUNK     (16u * MC_STREAM_BLOCK)    // 262144 muestras por reclamo
+
+typedef struct {
+    _Alignas(RT_CACHELINE) uint64_t acc[RT_NACC];
+} rt_partial_t;
+
+typedef void (*rt_task_fn)(int id, void *arg);
+typedef void (*rt_range_fn)(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], void *ctx);
+
+typedef struct rt_pool rt_pool_t;
+
+typedef struct {
+    rt_pool_t *pool;
+    int id;
+} rt_worker_t;
+
+struct rt_pool {
+    int T;
+    pthread_t *th;              // T-1 hilos (el id 0 es el que llama)
+    rt_worker_t *w;
+    rt_partial_t *part;         // T parciales, uno por línea de caché
+    pthread_mutex_t mu;
+    pthread_cond_t cv_start, cv_done;
+    unsigned long gen;          // generación de trabajo: cambia en cada run
+    int pending;                // hilos que aún no terminan (o no están listos)
+    int stop;
+    rt_task_fn fn;
+    void *arg;
+    rt_task_fn on_start;
+    void *start_ctx;
+};
+
+static inline void* rt_worker_main(void *arg) {
+    rt_worker_t *w = (rt_worker_t*)arg;
+    rt_pool_t *p = w->pool;
+    if (p->on_start) p->on_start(w->id, p->start_ctx);
+
+    pthread_mutex_lock(&p->mu);
+    unsigned long seen = p->gen;
+    if (--p->pending == 0) pthread_cond_signal(&p->cv_done);   // listo
+    for (;;) {
+        while (p->gen == seen && !p->stop) pthread_cond_wait(&p->cv_start, &p->mu);
+        if (p->stop) break;
+        seen = p->gen;
+        rt_task_fn fn = p->fn;
+        void *fa = p->arg;
+        pthread_mutex_unlock(&p->mu);
+        fn(w->id, fa);
+        pthread_mutex_lock(&p->mu);
+        if (--p->pending == 0) pthread_cond_signal(&p->cv_done);
+    }
+    pthread_mutex_unlock(&p->mu);
+    return NULL;
+}
+
+static inline void rt_pool_destroy(rt_pool_t *p) {
+    pthread_mutex_lock(&p->mu);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->cv_start);
+    pthread_mutex_unlock(&p->mu);
+    for (int i = 1; i < p->T; ++i) pthread_join(p->th[i - 1], NULL);
+    pthread_cond_destroy(&p->cv_start);
+    pthread_cond_destroy(&p->cv_done);
+    pthread_mutex_destroy(&p->mu);
+    free(p->th); free(p->w); free(p->part);
+}
+
+// Crea T-1 hilos y espera a que todos estén listos. on_start(id, ctx) corre
+// una vez en cada hilo (también en el que llama, como id 0); puede ser NULL.
+// 0 si todo bien, -1 si falla una reserva o pthread_create.
+static inline int rt_pool_init(rt_pool_t *p, int T, rt_task_fn on_start, void *start_ctx) {
+    memset(p, 0, sizeof *p);
+    p->T = T < 1 ? 1 : T;
+    p->on_start = on_start;
+    p->start_ctx = start_ctx;
+    p->th   = (pthread_t*)malloc((size_t)p->T * sizeof *p->th);
+    p->w    = (rt_worker_t*)malloc((size_t)p->T * sizeof *p->w);
+    p->part = (rt_partial_t*)aligned_alloc(RT_CACHELINE, (size_t)p->T * sizeof *p->part);
+    if (!p->th || !p->w || !p->part) {
+        free(p->th); free(p->w); free(p->part);
+        return -1;
+    }
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->cv_start, NULL);
+    pthread_cond_init(&p->cv_done, NULL);
+
+    int created = 1;
+    pthread_mutex_lock(&p->mu);
+    p->pending = p->T - 1;
+    pthread_mutex_unlock(&p->mu);
+    for (; created < p->T; ++created) {
+        p->w[created].pool = p;
+        p->w[created].id = created;
+        if (pthread_create(&p->th[created - 1], NULL, rt_worker_main, &p->w[created]) != 0)
+            break;
+    }
+    if (on_start) on_start(0, start_ctx);
+
+    pthread_mutex_lock(&p->mu);
+    p->pending -= p->T - created;            // los que no se crearon no avisan
+    while (p->pending > 0) pthread_cond_wait(&p->cv_done, &p->mu);
+    pthread_mutex_unlock(&p->mu);
+    if (created < p->T) {
+        p->T = created;
+        rt_pool_destroy(p);
+        return -1;
+    }
+    return 0;
+}
+
+// Ejecuta fn(id, arg) en los T hilos (id 0 = el que llama) y espera a todos
+static inline void rt_pool_run(rt_pool_t *p, rt_task_fn fn, void *arg) {
+    pthread_mutex_lock(&p->mu);
+    p->fn = fn;
+    p->arg = arg;
+    p->pending = p->T - 1;
+    ++p->gen;
+    pthread_cond_broadcast(&p->cv_start);
+    pthread_mutex_unlock(&p->mu);
+
+    fn(0, arg);
+
+    pthread_mutex_lock(&p->mu);
+    while (p->pending > 0) pthread_cond_wait(&p->cv_done, &p->mu);
+    pthread_mutex_unlock(&p->mu);
+}
+
+typedef struct {
+    rt_pool_t *pool;
+    _Alignas(RT_CACHELINE) _Atomic uint64_t next;   // línea propia: la tocan todos
+    uint64_t n, chunk;
+    rt_range_fn body;
+    void *ctx;
+} rt_reduce_t;
+
+static inline void rt_reduce_task(int id, void *arg) {
+    rt_reduce_t *r = (rt_reduce_t*)arg;
+    uint64_t *acc = r->pool->part[id].acc;
+    for (int k = 0; k < RT_NACC; ++k) acc[k] = 0;
+    for (;;) {
+        uint64_t a = atomic_fetch_add_explicit(&r->next, r->chunk, memory_order_relaxed);
+        if (a >= r->n) break;
+        uint64_t b = r->n - a < r->chunk ? r->n : a + r->chunk;
+        r->body(a, b, acc, r->ctx);
+    }
+}
+
+// out[k] = suma sobre hilos de acc[k] tras aplicar body a todos los trozos de [0,n)
+static inline void rt_parallel_reduce(rt_pool_t *p, uint64_t n, uint64_t chunk,
+                                      rt_range_fn body, void *ctx, uint64_t out[RT_NACC]) {
+    rt_reduce_t r;
+    r.pool = p;
+    atomic_init(&r.next, 0);
+    r.n = n;
+    r.chunk = chunk ? chunk : RT_CHUNK;
+    r.body = body;
+    r.ctx = ctx;
+    rt_pool_run(p, rt_reduce_task, &r);
+    for (int k = 0; k < RT_NACC; ++k) out[k] = 0;
+    for (int i = 0; i < p->T; ++i)
+        for (int k = 0; k < RT_NACC; ++k) out[k] += p->part[i].acc[k];
+}
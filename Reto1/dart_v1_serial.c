@@ -13,23 +13,27 @@ int main(int argc, char** argv){
     (void)argv[2]; // T se ignora en versión secuencial
     const char* outfile = argv[3];
 
-    // Semilla fija para reproducibilidad (puedes cambiarla si quieres)
-    rng64_t rng = { .s = 0x9e3779b97f4a7c15ULL };
-    long long hit = 0;
+    // Semilla fija para reproducibilidad: flujo por índice de muestra (DART_SEED)
+    // dardo: HPC_DART=int (defecto, 1 valor de 64 bits por dardo) | double | float
+    // (o HPC_MC_PREC=double|float; si las dos se contradicen, error)
+    int mode = mc_dart_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_DART desconocido (int|double|float) o en conflicto con HPC_MC_PREC\n");
+        return 1;
+    }
 
     double t0 = sec_now();
-    for (long long i = 0; i < N; ++i){
-        double x = rand01(&rng);
-        double y = rand01(&rng);
-        if (x*x + y*y <= 1.0) hit++;
-    }
+    // volatile: sin HPC_MC_COUNT el conteo no se imprime y -O3 podría eliminar el cómputo
+    volatile long long hit = (long long)mc_dart_count_stream(DART_SEED, 0, (uint64_t)N, mode);
     double t1 = sec_now();
     double elapsed = t1 - t0;
 
     FILE *f = fopen(outfile, "a");
     if (f) {
         // Formato requerido: "N=<valor> <tiempo>"
-        fprintf(f, "N=%lld %.6f\n", N, elapsed);
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (mc_count_enabled()) fprintf(f, " count=%lld", (long long)hit);
+        fprintf(f, "\n");
         fclose(f);
     } else {
         perror("fopen");
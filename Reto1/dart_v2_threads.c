@@ -5,25 +5,11 @@
 #include <pthread.h>
 #include <string.h>
 #include "common.h"
+#include "../common/mc_engine.h"   // después de common.h: genera el backend de hilos
+#include "../common/affinity.h"
 
-typedef struct {
-    long long a, b;     // rango [a,b)
-    uint64_t seed;      // semilla por hilo
-    long long local_hit;
-} task_t;
-
-static void* worker(void* arg){
-    task_t* t = (task_t*)arg;
-    rng64_t rng = {.s = t->seed};
-    long long hit = 0;
-    for (long long i = t->a; i < t->b; ++i){
-        (void)i; // el índice solo divide trabajo
-        double x = rand01(&rng);
-        double y = rand01(&rng);
-        if (x*x + y*y <= 1.0) hit++;
-    }
-    t->local_hit = hit;
-    return NULL;
+static void pin(int id, void* aff){
+    affinity_pin_thread((const affinity_t*)aff, id);
 }
 
 int main(int argc, char** argv){
@@ -36,43 +22,52 @@ int main(int argc, char** argv){
     const char* outfile = argv[3];
     if (T <= 0) T = 1;
 
-    pthread_t* th   = (pthread_t*)malloc(T*sizeof(*th));
-    task_t*    tasks= (task_t*)calloc(T, sizeof(*tasks));
-
-    long long chunk = N / T, rem = N % T;
-
-    // Preparar tareas y CREAR hilos
-    for (int i=0;i<T;i++){
-        long long a = i*chunk + (i<rem? i : rem);
-        long long b = a + chunk + (i<rem?1:0);
-        tasks[i].a = a; tasks[i].b = b;
-        tasks[i].seed = 0x9e3779b97f4a7c15ULL ^ (uint64_t)(i+1);
-        tasks[i].local_hit = 0;
-        pthread_create(&th[i], NULL, worker, &tasks[i]);
+    // dardo: HPC_DART=int (defecto, 1 valor de 64 bits por dardo) | double | float
+    // (o HPC_MC_PREC=double|float; si las dos se contradicen, error)
+    int mode = mc_dart_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_DART desconocido (int|double|float) o en conflicto con HPC_MC_PREC\n");
+        return 1;
     }
 
-    // Medir SOLO el cómputo: desde que todos los hilos ya están creados
-    double t0 = sec_now();
+    // Afinidad opcional (HPC_AFFINITY=compact|scatter|cores|list:...)
+    affinity_t aff;
+    affinity_from_env(&aff, T);
 
-    long long total = 0;
-    for (int i=0;i<T;i++){
-        pthread_join(th[i], NULL);
-        total += tasks[i].local_hit;
+    // Pool: hilos creados, fijados y esperando antes de medir
+    rt_pool_t pool;
+    if (rt_pool_init(&pool, T, pin, &aff) != 0){
+        fprintf(stderr, "no se pudieron crear %d hilos\n", T);
+        affinity_release(&aff);
+        return 1;
     }
+    mc_engine_dart_mode_p dp = { mode };
 
+    // Medir la región paralela completa: soltar hilos, trozos dinámicos, esperar a todos
+    // (un trozo [a,b) del flujo: el conteo no depende de qué hilo lo tome)
+    mc_acc_t acc;
+    double t0 = sec_now();
+    mc_engine_dart_mode_run_threads(&pool, DART_SEED, (uint64_t)N, &dp, &acc);
     double t1 = sec_now();
     double elapsed = t1 - t0;
+    rt_pool_destroy(&pool);
+    long long total = (long long)acc.hits;
 
     FILE *f = fopen(outfile, "a");
     if (f) {
-        fprintf(f, "N=%lld %.6f\n", N, elapsed);
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (aff.enabled) {
+            char buf[512];
+            fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+        }
+        if (mc_count_enabled()) fprintf(f, " count=%lld", total);
+        fprintf(f, "\n");
         fclose(f);
     } else {
         perror("fopen");
-        free(th); free(tasks);
+        affinity_release(&aff);
         return 2;
     }
-
-    free(th); free(tasks);
+    affinity_release(&aff);
     return 0;
 }
@@ -3,94 +3,76 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <sys/wait.h>
-#include <sys/mman.h>
 #include <string.h>
 #include "common.h"
+#include "fork_rt.h"      // pool pre-forkeado: barrera futex + slots compartidos
+#include "../common/mc_engine.h"   // después de fork_rt.h: genera mc_engine_run_fork
+#include "../common/affinity.h"
+
+static void pin(int i, void* aff){
+    affinity_pin_process((const affinity_t*)aff, i);
+}
 
 int main(int argc, char** argv){
     if (argc < 4){
-        fprintf(stderr, "Uso: %s N P outfile\n", argv[0]);
+        fprintf(stderr, "Uso: %s N[,N2,...] P outfile\n", argv[0]);
         return 1;
     }
-    long long N = atoll(argv[1]);
     int P = atoi(argv[2]);
     const char* outfile = argv[3];
     if (P <= 0) P = 1;
 
-    // pipes para reducción (1 por hijo)
-    int (*pipes)[2] = malloc((size_t)P * sizeof *pipes);
-    if (!pipes){ perror("malloc"); return 2; }
-
-    // barrera start en memoria compartida (MAP_SHARED|ANON)
-    volatile int* start = mmap(NULL, sizeof(int),
-                               PROT_READ | PROT_WRITE,
-                               MAP_SHARED | MAP_ANON, -1, 0);
-    if (start == MAP_FAILED){ perror("mmap"); free(pipes); return 2; }
-    *start = 0;
-
-    long long chunk = N / P, rem = N % P;
-
-    // fork de todos los hijos
-    for (int i=0;i<P;i++){
-        if (pipe(pipes[i]) != 0){ perror("pipe"); return 2; }
-        pid_t pid = fork();
-        if (pid < 0){
-            perror("fork"); return 2;
-        }
-        if (pid == 0){
-            // --- Hijo ---
-            close(pipes[i][0]); // cierra lectura
-            // Espera barrera
-            while (!*start) { /* spin */ }
-            __sync_synchronize(); // barrera de memoria
-
-            long long a = i*chunk + (i<rem? i : rem);
-            long long b = a + chunk + (i<rem?1:0);
+    // dardo: HPC_DART=int (defecto, 1 valor de 64 bits por dardo) | double | float
+    // (o HPC_MC_PREC=double|float; si las dos se contradicen, error)
+    int mode = mc_dart_mode_from_env();
+    if (mode < 0){
+        fprintf(stderr, "HPC_DART desconocido (int|double|float) o en conflicto con HPC_MC_PREC\n");
+        return 1;
+    }
 
-            // RNG por proceso
-            rng64_t rng = { .s = 0x9e3779b97f4a7c15ULL ^ (uint64_t)(i+1) };
+    // Afinidad opcional (HPC_AFFINITY=compact|scatter|cores|list:...)
+    affinity_t aff;
+    affinity_from_env(&aff, P);
 
-            long long hit = 0;
-            for (long long k = a; k < b; ++k){
-                (void)k;
-                double x = rand01(&rng), y = rand01(&rng);
-                if (x*x + y*y <= 1.0) hit++;
-            }
-            // Envía parcial y sale
-            if (write(pipes[i][1], &hit, sizeof(hit)) != sizeof(hit)) { /* ignore */ }
-            close(pipes[i][1]);
-            _exit(0);
-        } else {
-            // --- Padre ---
-            close(pipes[i][1]); // cierra escritura
-        }
+    // Hijos creados una vez y dormidos en la barrera antes de medir; cada uno
+    // cuenta su tramo del flujo con el dardo del motor (dp y job viven hasta el final)
+    mc_engine_dart_mode_p dp = { mode };
+    mc_engine_job_t job = { DART_SEED, &dp };
+    fk_pool_t pool;
+    if (fk_pool_init(&pool, P, mc_engine_dart_mode_range, &job, pin, &aff) != 0){
+        perror("fork");
+        affinity_release(&aff);
+        return 2;
     }
 
-    // Arranque del cómputo: levantar barrera y arrancar cronómetro
-    __sync_synchronize();
-    *(int*)start = 1;
-    __sync_synchronize();
+    // N puede ser una lista "100000000,500000000,...": el mismo pool para todos,
+    // una línea de salida por N
+    FILE *f = fopen(outfile, "a");
+    if (!f){ perror("fopen"); fk_pool_destroy(&pool); affinity_release(&aff); return 2; }
+    for (const char* s = argv[1]; *s; ){
+        char* end;
+        long long N = strtoll(s, &end, 10);
+        if (end == s) break;
+        s = (*end == ',') ? end + 1 : end;
 
-    double t0 = sec_now();
+        mc_acc_t acc;
+        double t0 = sec_now();
+        mc_engine_run_fork(&pool, (uint64_t)N, &acc);
+        double t1 = sec_now();
+        double elapsed = t1 - t0;
+        long long total = (long long)acc.hits;
 
-    long long total = 0, tmp = 0;
-    int status = 0;
-    for (int i=0;i<P;i++){
-        if (read(pipes[i][0], &tmp, sizeof(tmp)) == sizeof(tmp)) total += tmp;
-        close(pipes[i][0]);
-        wait(&status);
+        fprintf(f, "N=%lld %.6f", N, elapsed);
+        if (aff.enabled) {
+            char buf[512];
+            fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+        }
+        if (mc_count_enabled()) fprintf(f, " count=%lld", total);
+        fprintf(f, "\n");
     }
+    fclose(f);
 
-    double t1 = sec_now();
-    double elapsed = t1 - t0;
-
-    // salida
-    FILE *f = fopen(outfile, "a");
-    if (f) { fprintf(f, "N=%lld %.6f\n", N, elapsed); fclose(f); }
-    else { perror("fopen"); }
-
-    munmap((void*)start, sizeof(int));
-    free(pipes);
+    fk_pool_destroy(&pool);
+    affinity_release(&aff);
     return 0;
 }
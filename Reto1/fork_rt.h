@@ -0,0 +1,158 @@
+// fork_rt.h — pool de procesos pre-forkeados con barrera futex y resultados compartidos
+//
+// Antes cada hijo giraba en while(!*start) mientras el padre seguía haciendo
+// fork: con P=8 los hijos ya creados le robaban CPU a los fork pendientes, y
+// los parciales volvían por un pipe por hijo. Aquí todo vive en una región
+// MAP_SHARED|MAP_ANON:
+//
+//   gen    palabra futex de "trabajo nuevo": los hijos duermen en FUTEX_WAIT
+//          hasta que el padre la incrementa y hace FUTEX_WAKE (barrera de
+//          inicio sin giro)
+//   done   hijos que terminaron la generación actual; el último despierta al
+//          padre con FUTEX_WAKE (también se usa una vez como barrera de "listos")
+//   slot[] un resultado por hijo, cada uno en su propia línea de caché
+//
+// Los hijos se crean UNA vez (fk_pool_init no vuelve hasta que todos duermen)
+// y se reutilizan en cada fk_pool_run, p. ej. para varios N seguidos. El
+// tiempo medido alrededor de fk_pool_run es la región completa: despertar,
+// cómputo y aviso del último hijo.
+//
+// Se usan futex compartidos (sin FUTEX_PRIVATE_FLAG): la memoria es de
+// varios procesos. Solo Linux; requiere _GNU_SOURCE antes de los #include.
+//
+// Uso:
+//   static void body(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], const void *ctx);
+//   fk_pool_t pool;
+//   if (fk_pool_init(&pool, P, body, &ctx, on_start, &aff) != 0) ...error...
+//   uint64_t acc[RT_NACC];
+//   fk_pool_run(&pool, N, acc);          // el hijo i cuenta su tramo de mc_stream_split
+//   fk_pool_destroy(&pool);
+
+#pragma once
+#define FK_RT_H   // mc_engine.h añade mc_engine_run_fork si ve este runtime
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "common.h"
+
+typedef void (*fk_range_fn)(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], const void *ctx);
+
+typedef struct {
+    _Alignas(RT_CACHELINE) uint64_t acc[RT_NACC];
+} fk_slot_t;
+
+typedef struct {
+    _Alignas(RT_CACHELINE) _Atomic uint32_t gen;   // futex de inicio
+    _Alignas(RT_CACHELINE) _Atomic uint32_t done;  // futex de fin
+    _Atomic int stop;
+    uint64_t N;                                    // muestras de la generación actual
+    fk_slot_t slot[];                              // P resultados
+} fk_shared_t;
+
+typedef struct {
+    int P;
+    pid_t *pid;
+    fk_shared_t *sh;
+    size_t bytes;
+} fk_pool_t;
+
+static inline void fk_futex_wait(_Atomic uint32_t *w, uint32_t val) {
+    syscall(SYS_futex, (uint32_t*)w, FUTEX_WAIT, val, NULL, NULL, 0);
+}
+
+static inline void fk_futex_wake(_Atomic uint32_t *w) {
+    syscall(SYS_futex, (uint32_t*)w, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+// Suma 1 a done; el último de P despierta al padre
+static inline void fk_arrive(fk_shared_t *sh, int P) {
+    if (atomic_fetch_add_explicit(&sh->done, 1, memory_order_acq_rel) + 1 == (uint32_t)P)
+        fk_futex_wake(&sh->done);
+}
+
+// El padre duerme hasta que done == P
+static inline void fk_wait_all(fk_shared_t *sh, int P) {
+    uint32_t d;
+    while ((d = atomic_load_explicit(&sh->done, memory_order_acquire)) < (uint32_t)P)
+        fk_futex_wait(&sh->done, d);
+}
+
+static inline void fk_child(fk_shared_t *sh, int P, int i, fk_range_fn body, const void *ctx) {
+    uint32_t seen = atomic_load_explicit(&sh->gen, memory_order_acquire);
+    fk_arrive(sh, P);                                   // listo
+    for (;;) {
+        uint32_t g;
+        while ((g = atomic_load_explicit(&sh->gen, memory_order_acquire)) == seen)
+            fk_futex_wait(&sh->gen, seen);
+        seen = g;
+        if (atomic_load_explicit(&sh->stop, memory_order_relaxed)) break;
+
+        uint64_t a, b;   // tramo alineado a bloques del flujo
+        mc_stream_split(sh->N, (uint64_t)P, (uint64_t)i, &a, &b);
+        uint64_t acc[RT_NACC] = {0};
+        body(a, b, acc, ctx);
+        for (int k = 0; k < RT_NACC; ++k) sh->slot[i].acc[k] = acc[k];
+        fk_arrive(sh, P);
+    }
+    _exit(0);
+}
+
+static inline void fk_pool_destroy(fk_pool_t *p) {
+    atomic_store_explicit(&p->sh->stop, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p->sh->gen, 1, memory_order_release);
+    fk_futex_wake(&p->sh->gen);
+    for (int i = 0; i < p->P; ++i) waitpid(p->pid[i], NULL, 0);
+    munmap(p->sh, p->bytes);
+    free(p->pid);
+}
+
+// Hace fork de P hijos y espera a que todos duerman en la barrera.
+// on_start(i, start_ctx) corre en cada hijo tras el fork (p. ej. afinidad);
+// puede ser NULL. 0 si todo bien, -1 si falla mmap, malloc o fork.
+static inline int fk_pool_init(fk_pool_t *p, int P, fk_range_fn body, const void *ctx,
+                               rt_task_fn on_start, void *start_ctx) {
+    p->P = P < 1 ? 1 : P;
+    p->bytes = sizeof(fk_shared_t) + (size_t)p->P * sizeof(fk_slot_t);
+    p->pid = (pid_t*)malloc((size_t)p->P * sizeof *p->pid);
+    if (!p->pid) return -1;
+    p->sh = (fk_shared_t*)mmap(NULL, p->bytes, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANON, -1, 0);
+    if (p->sh == MAP_FAILED) { free(p->pid); return -1; }
+    memset(p->sh, 0, p->bytes);
+
+    int created = 0;
+    for (; created < p->P; ++created) {
+        pid_t pid = fork();
+        if (pid < 0) break;
+        if (pid == 0) {
+            if (on_start) on_start(created, start_ctx);
+            fk_child(p->sh, p->P, created, body, ctx);
+        }
+        p->pid[created] = pid;
+    }
+    if (created < p->P) {
+        p->P = created;   // los creados esperan en gen: se los detiene
+        fk_pool_destroy(p);
+        return -1;
+    }
+    fk_wait_all(p->sh, p->P);
+    return 0;
+}
+
+// Cuenta [0,N) repartido entre los P hijos; out[k] = suma de los slots
+static inline void fk_pool_run(fk_pool_t *p, uint64_t N, uint64_t out[RT_NACC]) {
+    fk_shared_t *sh = p->sh;
+    sh->N = N;
+    atomic_store_explicit(&sh->done, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&sh->gen, 1, memory_order_release);   // publica N y done=0
+    fk_futex_wake(&sh->gen);
+    fk_wait_all(sh, p->P);
+    for (int k = 0; k < RT_NACC; ++k) out[k] = 0;
+    for (int i = 0; i < p->P; ++i)
+        for (int k = 0; k < RT_NACC; ++k) out[k] += sh->slot[i].acc[k];
+}
@@ -0,0 +1,275 @@
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+/* pi_bench: un solo proceso que mide el dardo o la aguja de Buffon con todos
+ * los backends (serial, hilos, fork, OpenMP) sobre el MISMO flujo reproducible
+ *
+ * Cada backend cuenta [0,N) del flujo de rng_stream.h con el mismo kernel
+ * (mc_kernels.h): los conteos deben ser idénticos bit a bit. Se comparan con
+ * el serial (columna agree) y si alguno difiere el programa termina con 5.
+ *
+ *   serial    mc_*_count_stream en el hilo principal (línea base)
+ *   pthreads  rt_pool_t + rt_parallel_reduce de common.h (trozos dinámicos)
+ *   fork      fk_pool_t de fork_rt.h (tramos estáticos, barrera futex)
+ *   omp       #pragma omp parallel con mc_stream_split (como los *_omp de Reto2)
+ *
+ * Los pools se crean (y se fijan con HPC_AFFINITY) fuera de la medición y se
+ * reutilizan para todos los N y repeticiones; el tiempo es solo la región
+ * paralela. speedup y efficiency son contra la mediana del serial con el
+ * mismo N. HPC_DART, HPC_BUFFON_SIN y HPC_MC_PREC eligen el kernel como en
+ * los demás programas.
+ *
+ * Compilar: gcc -O3 -march=native -std=c11 -fopenmp -pthread pi_bench.c -o pi_bench -lm
+ * Uso:
+ *   ./pi_bench --method=dart|buffon [--backend=serial,pthreads,fork,omp|all]
+ *              [--threads=1,2,4,8] [--n=N1,N2,...] [--reps=R] [--seed=S]
+ *              [--out=archivo.csv]
+ * Salida (append; encabezado si el archivo está vacío), una fila por corrida:
+ *   method,backend,N,workers,rep,count,pi,time_s,samples_per_s,speedup,efficiency,agree
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "common.h"
+#include "fork_rt.h"
+#include "../common/mc_adaptive.h"   // mc_pi_estimate
+#include "../common/affinity.h"
+
+#define PB_MAX_LIST 32
+
+enum { PB_SERIAL = 0, PB_PTHREADS, PB_FORK, PB_OMP, PB_NBACKENDS };
+static const char *const pb_backend_names[PB_NBACKENDS] = { "serial", "pthreads", "fork", "omp" };
+
+typedef struct {
+    int kind;           // MC_EST_DART | MC_EST_BUFFON
+    uint64_t seed;
+    int mode;           // MC_DART_* o modo de Buffon (con MC_BUFFON_DOUBLE)
+} pb_ctx_t;
+
+// acc[0] aciertos/cruces, acc[1] muestras/agujas de [a,b)
+static inline void pb_count(const pb_ctx_t *c, uint64_t a, uint64_t b, uint64_t acc[RT_NACC]){
+    if (c->kind == MC_EST_DART){
+        acc[0] += mc_dart_count_stream(c->seed, a, b, c->mode);
+        acc[1] += b - a;
+    } else {
+        acc[0] += mc_buffon_count_stream_m(c->seed, a, b, 1.0, 1.0, c->mode, &acc[1]);
+    }
+}
+
+static void pb_body_rt(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], void *ctx){
+    pb_count((const pb_ctx_t*)ctx, a, b, acc);
+}
+
+static void pb_body_fk(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], const void *ctx){
+    pb_count((const pb_ctx_t*)ctx, a, b, acc);
+}
+
+static void pin_thread(int id, void *aff){ affinity_pin_thread((const affinity_t*)aff, id); }
+static void pin_process(int id, void *aff){ affinity_pin_process((const affinity_t*)aff, id); }
+
+// Región medida del backend omp: sin fijar afinidad (el equipo ya se fijó)
+static void pb_omp_run(const pb_ctx_t *c, int T, uint64_t N, uint64_t out[RT_NACC]){
+    uint64_t h = 0, n = 0;
+    #pragma omp parallel num_threads(T) reduction(+:h, n)
+    {
+        uint64_t a, b, acc[RT_NACC] = {0};
+        mc_stream_split(N, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &a, &b);
+        pb_count(c, a, b, acc);
+        h += acc[0];
+        n += acc[1];
+    }
+    out[0] = h;
+    out[1] = n;
+}
+
+// "a,b,c" -> enteros; devuelve cuántos (0 si hay algo inválido)
+static int pb_parse_list(const char *s, uint64_t *out, int max){
+    int k = 0;
+    while (*s && k < max){
+        char *end;
+        unsigned long long v = strtoull(s, &end, 10);
+        if (end == s || v == 0) return 0;
+        out[k++] = v;
+        if (*end == ',') s = end + 1;
+        else if (*end == '\0') s = end;
+        else return 0;
+    }
+    return *s ? 0 : k;
+}
+
+// "serial,omp" | "all" -> máscara de backends; 0 si hay uno desconocido
+static int pb_parse_backends(const char *s){
+    if (strcmp(s, "all") == 0) return (1 << PB_NBACKENDS) - 1;
+    int mask = 0;
+    char buf[256];
+    snprintf(buf, sizeof buf, "%s", s);
+    for (char *save = NULL, *t = strtok_r(buf, ",", &save); t; t = strtok_r(NULL, ",", &save)){
+        int found = 0;
+        for (int b = 0; b < PB_NBACKENDS; ++b)
+            if (strcmp(t, pb_backend_names[b]) == 0){ mask |= 1 << b; found = 1; }
+        if (!found) return 0;
+    }
+    return mask;
+}
+
+static int cmp_double(const void *x, const void *y){
+    double a = *(const double*)x, b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+typedef struct {
+    FILE *f;
+    const char *method;
+    int kind;
+    int mismatches;
+} pb_out_t;
+
+static void pb_row(pb_out_t *o, int backend, uint64_t N, int workers, int rep,
+                   const uint64_t acc[RT_NACC], double sec, double t_serial, uint64_t ref){
+    double pi = mc_pi_estimate(o->kind, acc[0], acc[1], 1.0);
+    double speedup = t_serial > 0.0 ? t_serial / sec : 0.0;
+    int agree = acc[0] == ref;
+    if (!agree) o->mismatches++;
+    fprintf(o->f, "%s,%s,%llu,%d,%d,%llu,%.9f,%.6f,%.4e,%.3f,%.3f,%d\n",
+            o->method, pb_backend_names[backend], (unsigned long long)N, workers, rep,
+            (unsigned long long)acc[0], pi, sec, (double)N / sec,
+            speedup, speedup / workers, agree);
+}
+
+int main(int argc, char** argv){
+    const char *method = NULL, *backends = "all", *out_path = "pi_bench.csv";
+    const char *threads_s = "1,2,4,8", *n_s = "100000000";
+    int reps = 3;
+    uint64_t seed = 0;
+    int have_seed = 0;
+    for (int i = 1; i < argc; ++i){
+        const char *a = argv[i];
+        if      (strncmp(a, "--method=", 9) == 0)  method = a + 9;
+        else if (strncmp(a, "--backend=", 10) == 0) backends = a + 10;
+        else if (strncmp(a, "--threads=", 10) == 0) threads_s = a + 10;
+        else if (strncmp(a, "--n=", 4) == 0)        n_s = a + 4;
+        else if (strncmp(a, "--reps=", 7) == 0)     reps = atoi(a + 7);
+        else if (strncmp(a, "--seed=", 7) == 0){    seed = strtoull(a + 7, NULL, 10); have_seed = 1; }
+        else if (strncmp(a, "--out=", 6) == 0)      out_path = a + 6;
+        else method = NULL, i = argc;               // opción desconocida: uso
+    }
+
+    pb_ctx_t ctx;
+    if (method && strcmp(method, "dart") == 0){
+        ctx.kind = MC_EST_DART;
+        ctx.seed = DART_SEED;
+        ctx.mode = mc_dart_mode_from_env();
+    } else if (method && strcmp(method, "buffon") == 0){
+        ctx.kind = MC_EST_BUFFON;
+        ctx.seed = BUFFON_SEED;
+        ctx.mode = mc_buffon_mode_from_env();
+    } else {
+        fprintf(stderr, "Uso: %s --method=dart|buffon [--backend=serial,pthreads,fork,omp|all]\n"
+                        "       [--threads=1,2,4,8] [--n=N1,N2,...] [--reps=R] [--seed=S] [--out=csv]\n",
+                argv[0]);
+        return 1;
+    }
+    if (have_seed) ctx.seed = seed;
+    uint64_t Ts[PB_MAX_LIST], Ns[PB_MAX_LIST];
+    int nT = pb_parse_list(threads_s, Ts, PB_MAX_LIST), nN = pb_parse_list(n_s, Ns, PB_MAX_LIST);
+    int mask = pb_parse_backends(backends);
+    if (ctx.mode < 0 || nT == 0 || nN == 0 || mask == 0 || reps < 1){
+        fprintf(stderr, "argumentos o variables HPC_* inválidos\n");
+        return 1;
+    }
+
+    FILE *f = fopen(out_path, "a");
+    if (!f){ perror("fopen"); return 2; }
+    if (ftell(f) == 0)
+        fprintf(f, "method,backend,N,workers,rep,count,pi,time_s,samples_per_s,speedup,efficiency,agree\n");
+    pb_out_t o = { f, method, ctx.kind, 0 };
+
+    // Línea base: serial, siempre (referencia de conteo y de tiempo)
+    double t_serial[PB_MAX_LIST];
+    uint64_t ref[PB_MAX_LIST], ref_n[PB_MAX_LIST];
+    double *ts = malloc((size_t)reps * sizeof *ts);
+    if (!ts){ fclose(f); return 2; }
+    for (int j = 0; j < nN; ++j){
+        uint64_t acc[RT_NACC];
+        for (int r = 0; r < reps; ++r){
+            acc[0] = acc[1] = 0;
+            double t0 = sec_now();
+            pb_count(&ctx, 0, Ns[j], acc);
+            ts[r] = sec_now() - t0;
+        }
+        ref[j] = acc[0];
+        ref_n[j] = acc[1];
+        qsort(ts, (size_t)reps, sizeof *ts, cmp_double);
+        t_serial[j] = ts[reps / 2];
+    }
+    if (mask & (1 << PB_SERIAL))
+        for (int j = 0; j < nN; ++j){
+            uint64_t acc[RT_NACC] = { ref[j], ref_n[j] };
+            pb_row(&o, PB_SERIAL, Ns[j], 1, 0, acc, t_serial[j], t_serial[j], ref[j]);
+        }
+    free(ts);
+
+    for (int i = 0; i < nT; ++i){
+        int T = (int)Ts[i];
+        affinity_t aff;
+        affinity_from_env(&aff, T);
+
+        if (mask & (1 << PB_PTHREADS)){
+            rt_pool_t pool;
+            if (rt_pool_init(&pool, T, pin_thread, &aff) != 0){
+                fprintf(stderr, "no se pudieron crear %d hilos\n", T);
+                affinity_release(&aff);
+                fclose(f);
+                return 2;
+            }
+            for (int j = 0; j < nN; ++j)
+                for (int r = 0; r < reps; ++r){
+                    uint64_t acc[RT_NACC];
+                    double t0 = sec_now();
+                    rt_parallel_reduce(&pool, Ns[j], RT_CHUNK, pb_body_rt, &ctx, acc);
+                    pb_row(&o, PB_PTHREADS, Ns[j], T, r, acc, sec_now() - t0, t_serial[j], ref[j]);
+                }
+            rt_pool_destroy(&pool);
+        }
+
+        if (mask & (1 << PB_FORK)){
+            fflush(f);   // los hijos heredan el búfer de stdio
+            fk_pool_t pool;
+            if (fk_pool_init(&pool, T, pb_body_fk, &ctx, pin_process, &aff) != 0){
+                fprintf(stderr, "no se pudieron crear %d procesos\n", T);
+                affinity_release(&aff);
+                fclose(f);
+                return 2;
+            }
+            for (int j = 0; j < nN; ++j)
+                for (int r = 0; r < reps; ++r){
+                    uint64_t acc[RT_NACC];
+                    double t0 = sec_now();
+                    fk_pool_run(&pool, Ns[j], acc);
+                    pb_row(&o, PB_FORK, Ns[j], T, r, acc, sec_now() - t0, t_serial[j], ref[j]);
+                }
+            fk_pool_destroy(&pool);
+        }
+
+        if (mask & (1 << PB_OMP)){
+            // crea el equipo de T hilos y los fija fuera de la medición;
+            // libgomp reutiliza los mismos hilos en las regiones siguientes
+            #pragma omp parallel num_threads(T)
+            affinity_pin_thread(&aff, omp_get_thread_num());
+            for (int j = 0; j < nN; ++j)
+                for (int r = 0; r < reps; ++r){
+                    uint64_t acc[RT_NACC];
+                    double t0 = sec_now();
+                    pb_omp_run(&ctx, T, Ns[j], acc);
+                    pb_row(&o, PB_OMP, Ns[j], T, r, acc, sec_now() - t0, t_serial[j], ref[j]);
+                }
+        }
+        affinity_release(&aff);   // la página del contador es de este T
+    }
+    fclose(f);
+    if (o.mismatches){
+        fprintf(stderr, "%d corridas con conteo distinto al serial\n", o.mismatches);
+        return 5;
+    }
+    return 0;
+}
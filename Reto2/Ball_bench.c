@@ -0,0 +1,105 @@
+#define _GNU_SOURCE
+/* Ball_bench: volumen de la d-bola e integrando en [0,1]^d (mc_ddim.h) según d
+ *
+ * Para cada d y cada kernel (ball, ball_soa, sumsq), con OpenMP:
+ *   Ms_s     millones de muestras por segundo
+ *   ns_coord ns por coordenada (= tiempo / (N d))
+ *   rng_ns   ns por uniforme de xr_simd_fill01 solo (mismo hilo, en L1)
+ *   block    bytes del bloque de coordenadas que recorre el kernel
+ *   bound    rng  si ns_coord <= 1.3 rng_ns (el generador manda)
+ *            mem  si no y el bloque no cabe en L1d
+ *            compute en otro caso
+ *   est/exact/relerr/se  estimación, valor exacto, error relativo, error estándar
+ *
+ * Uso: ./Ball_bench N outfile [seed]
+ * Salida (append), una línea por (d, kernel):
+ *   d=<d> kernel=<k> N=<N> threads=<T> est=<v> exact=<v> relerr=<e> se=<e>
+ *     Ms_s=<r> ns_coord=<t> rng_ns=<t> block=<bytes> bound=<rng|mem|compute>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include <omp.h>
+#include "../common/mc_ddim.h"
+
+static const int DIMS[] = { 2, 3, 4, 6, 8, 10, 12, 16, 20 };
+
+// ns por uniforme del generador SIMD, sin kernel
+static double rng_ns(uint64_t n){
+    xr_simd_t r;
+    xr_simd_seed(&r, 42);
+    _Alignas(64) double x[XR_BLOCK];
+    double sink = 0.0;
+    double t0 = omp_get_wtime();
+    for (uint64_t i = 0; i < n; i += XR_BLOCK){
+        xr_simd_fill01(&r, x, XR_BLOCK);
+        sink += x[0];
+    }
+    double t = omp_get_wtime() - t0;
+    if (sink < 0.0) printf("%f\n", sink);    // evita que se elimine el bucle
+    return 1e9 * t / (double)n;
+}
+
+int main(int argc, char** argv){
+    if (argc < 3) return 2;
+    uint64_t N = strtoull(argv[1], NULL, 10);
+    const char* out_path = argv[2];
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+    if (N == 0) return 3;
+
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (l1 <= 0) l1 = 32 * 1024;
+    int threads = omp_get_max_threads();
+    double rns = rng_ns(N < 100000000 ? N : 100000000);
+
+    FILE* f = fopen(out_path, "a");
+    if (!f) return 7;
+    for (size_t j = 0; j < sizeof DIMS / sizeof DIMS[0]; ++j){
+        int d = DIMS[j];
+        for (int kern = 0; kern < 3; ++kern){
+            mc_acc_t acc;
+            double est, exact, se, block;
+            const char* name;
+            double t0 = omp_get_wtime();
+            if (kern == 0){
+                mc_ball_p p = { d };
+                mc_ball_run_omp(seed, N, &p, &acc);
+                name = "ball";
+                block = 2.0 * XR_BLOCK * sizeof(double);
+            } else if (kern == 1){
+                mc_ball_p p = { d };
+                mc_ball_soa_run_omp(seed, N, &p, &acc);
+                name = "ball_soa";
+                block = (double)d * XR_BLOCK * sizeof(double);
+            } else {
+                mc_sumsq_p p = { d };
+                mc_sumsq_run_omp(seed, N, &p, &acc);
+                name = "sumsq";
+                block = (double)d * XR_BLOCK * sizeof(double);
+            }
+            double sec = omp_get_wtime() - t0;
+            if (kern < 2){
+                est = mc_ball_volume(d, &acc);
+                se = mc_ball_volume_stderr(d, &acc);
+                exact = mc_ball_volume_exact(d);
+            } else {
+                est = mc_sumsq_mean(&acc);
+                se = mc_sumsq_stderr(&acc);
+                exact = mc_sumsq_exact(d);
+            }
+            // por hilo: el generador se midió en un solo hilo
+            double ns_coord = 1e9 * sec * threads / ((double)N * d);
+            const char* bound = ns_coord <= 1.3 * rns ? "rng"
+                              : (block > (double)l1 ? "mem" : "compute");
+            fprintf(f, "d=%d kernel=%s N=%llu threads=%d est=%.9g exact=%.9g relerr=%.3e se=%.3e "
+                       "Ms_s=%.1f ns_coord=%.3f rng_ns=%.3f block=%.0f bound=%s\n",
+                    d, name, (unsigned long long)N, threads, est, exact,
+                    fabs(est - exact) / exact, se,
+                    1e-6 * (double)N / sec, ns_coord, rns, block, bound);
+        }
+    }
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <omp.h>
+#include "../common/mc_kernels.h"   // xoshiro256+ de 8 carriles + kernels por bloques
+#include "../common/mc_adaptive.h"  // HPC_MC_TARGET: parar al llegar al error objetivo
+#include "../common/mc_sampler.h"   // HPC_MC_SAMPLER: estratificado, antitético, Sobol/Halton
+#include "../common/mc_mpi.h"       // tramos por rank, rondas con MPI_Iallreduce
+
+/* Buffon híbrido MPI + OpenMP.
+ * Uso: mpirun -np R ./Buffon_mpi N outfile [seed]   (OMP_NUM_THREADS hilos por rank)
+ * Salida (append, rank 0): N,R*T,pi,time,ranks=R  (+ columnas de HPC_MC_TARGET/SAMPLER)
+ */
+
+typedef struct { uint64_t seed; float l, t; int mode, samp; } buffon_ctx_t;
+
+// Cruces y agujas de [a,b) repartido entre los hilos del rank
+static void buffon_range(uint64_t a, uint64_t b, uint64_t acc[2], const void* ctx){
+    const buffon_ctx_t* c = (const buffon_ctx_t*)ctx;
+    uint64_t hits = 0, needles = 0;
+    #pragma omp parallel reduction(+:hits,needles)
+    {
+        uint64_t x, y;
+        mc_mpi_subrange(a, b, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &x, &y);
+        if (c->samp != MC_SAMPLER_IID) {
+            // muestreadores en double (seno poly); una muestra = una aguja
+            hits    += mc_buffon_count_sampler(c->samp, c->seed, x, y, c->l, c->t);
+            needles += y - x;
+        } else {
+            hits += mc_buffon_count_stream_m(c->seed, x, y, c->l, c->t, c->mode, &needles);
+        }
+    }
+    acc[0] += hits;
+    acc[1] += needles;
+}
+
+int main(int argc, char** argv){
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    uint64_t N = (argc > 1)? strtoull(argv[1], NULL, 10) : (uint64_t)50000000;
+    // HPC_MPI_WEAK=1: N es por rank (escalamiento débil); total = N * R
+    if (mc_mpi_weak_from_env()) N *= (uint64_t)size;
+
+    // semilla del flujo reproducible (3er arg opcional): misma que _seq y _omp
+    buffon_ctx_t ctx;
+    ctx.seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 987654321ULL;
+    ctx.l = 1.0f; ctx.t = 1.0f;
+    ctx.mode = mc_buffon_mode_from_env();   // HPC_BUFFON_SIN + HPC_MC_PREC
+    int prec = mc_prec_from_env();   // validado junto con mode
+    ctx.samp = mc_sampler_from_env();
+    double target = mc_target_from_env();
+    if (ctx.mode < 0 || ctx.samp < 0 || (ctx.samp != MC_SAMPLER_IID && target > 0.0)){
+        MPI_Finalize();
+        return 3;
+    }
+    double ratio = (double)ctx.l / (double)ctx.t;
+
+    uint64_t tot[2];   // cruces, agujas (válidos en rank 0)
+    uint64_t used = N; // posiciones del flujo recorridas (propuestas en reject)
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    if (target > 0.0)
+        mc_mpi_run_target(N, target, MC_EST_BUFFON, ratio, buffon_range, &ctx, MPI_COMM_WORLD, tot, &used);
+    else
+        mc_mpi_run(N, buffon_range, &ctx, MPI_COMM_WORLD, tot);
+    double t1 = MPI_Wtime();
+
+    if (rank == 0){
+        if (tot[0] == 0){ MPI_Finalize(); return 2; }  // N muy pequeño
+        int threads = size * omp_get_max_threads();
+        double pi = 2.0 * ratio * (double)tot[1] / (double)tot[0];
+        const char* out_path = (argc > 2)? argv[2] : NULL;
+        FILE* f = out_path ? fopen(out_path, "a") : NULL;
+        if (f){
+            fprintf(f, "%llu,%d,%.9f,%.6f,ranks=%d",
+                    (unsigned long long)used, threads, pi, (t1 - t0), size);
+            if (target > 0.0) mc_mpi_report(f, MC_EST_BUFFON, tot, target, ratio);
+            if (ctx.samp != MC_SAMPLER_IID) fprintf(f, ",sampler=%s", mc_sampler_name(ctx.samp));
+            if (prec != MC_PREC_AUTO) fprintf(f, ",prec=%s", mc_prec_name(prec));
+            fprintf(f, "\n");
+            fclose(f);
+        }
+    }
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 200809L
+/* Buffon_sincheck: precisión y costo de los modos de seno de Buffon (mc_kernels.h)
+ *
+ *   sin_maxerr / sinf_maxerr  error absoluto máximo de mc_sin_poly / mc_sinf_poly
+ *                             contra sin() en una malla densa de [0, pi/2]
+ *   <modo>_cnt / <modo>_s     cruces y tiempo con el mismo flujo reproducible
+ *                             (libm, poly, reject) en double y en float
+ *   diff                      |cruces poly - cruces libm| (mismas muestras)
+ *
+ * Uso: ./Buffon_sincheck N outfile [seed]
+ * Salida (append), una línea por tipo:
+ *   N=<N> type=<double|float> sin_maxerr=<e> libm=<s> poly=<s> reject=<s>
+ *     pi_libm=<pi> pi_poly=<pi> pi_reject=<pi> diff=<cruces>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "../common/mc_kernels.h"
+
+static inline double now_sec(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+int main(int argc, char** argv){
+    if (argc < 3) return 2;
+    uint64_t N = strtoull(argv[1], NULL, 10);
+    const char* out_path = argv[2];
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 987654321ULL;
+    if (N == 0) return 3;
+
+    // error del polinomio en una malla de 2^24 puntos
+    const uint64_t G = 1u << 24;
+    double err_d = 0.0, err_f = 0.0;
+    for (uint64_t i = 0; i <= G; ++i){
+        double x = MC_PI_HALF * (double)i / (double)G;
+        double ed = fabs(mc_sin_poly(x) - sin(x));
+        double ef = fabs((double)mc_sinf_poly((float)x) - sin((double)(float)x));
+        if (ed > err_d) err_d = ed;
+        if (ef > err_f) err_f = ef;
+    }
+
+    FILE* f = fopen(out_path, "a");
+    if (!f) return 7;
+    for (int is_float = 0; is_float <= 1; ++is_float){
+        double sec[3], pi[3];
+        uint64_t cnt[3];
+        for (int mode = 0; mode < 3; ++mode){
+            uint64_t needles = 0;
+            double t0 = now_sec();
+            cnt[mode] = is_float
+                ? mc_buffon_count_stream_f(seed, 0, N, 1.0f, 1.0f, mode, &needles)
+                : mc_buffon_count_stream  (seed, 0, N, 1.0,  1.0,  mode, &needles);
+            sec[mode] = now_sec() - t0;
+            pi[mode]  = cnt[mode] ? 2.0 * (double)needles / (double)cnt[mode] : 0.0;
+        }
+        uint64_t diff = cnt[MC_SIN_POLY] > cnt[MC_SIN_LIBM] ? cnt[MC_SIN_POLY] - cnt[MC_SIN_LIBM]
+                                                             : cnt[MC_SIN_LIBM] - cnt[MC_SIN_POLY];
+        fprintf(f, "N=%llu type=%s sin_maxerr=%.3e libm=%.6f poly=%.6f reject=%.6f "
+                   "pi_libm=%.9f pi_poly=%.9f pi_reject=%.9f diff=%llu\n",
+                (unsigned long long)N, is_float ? "float" : "double",
+                is_float ? err_f : err_d,
+                sec[MC_SIN_LIBM], sec[MC_SIN_POLY], sec[MC_SIN_REJECT],
+                pi[MC_SIN_LIBM], pi[MC_SIN_POLY], pi[MC_SIN_REJECT],
+                (unsigned long long)diff);
+    }
+    fclose(f);
+    return 0;
+}
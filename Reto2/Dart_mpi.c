@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <omp.h>
+#include "../common/mc_kernels.h"   // xoshiro256+ de 8 carriles + kernels por bloques
+#include "../common/mc_adaptive.h"  // HPC_MC_TARGET: parar al llegar al error objetivo
+#include "../common/mc_sampler.h"   // HPC_MC_SAMPLER: estratificado, antitético, Sobol/Halton
+#include "../common/mc_mpi.h"       // tramos por rank, rondas con MPI_Iallreduce
+#include "../common/mc_engine.h"    // dardo iid: backend MPI (+ OpenMP) del motor
+
+/* Dardo híbrido MPI + OpenMP.
+ * Uso: mpirun -np R ./Dart_mpi N outfile [seed]   (OMP_NUM_THREADS hilos por rank)
+ * Salida (append, rank 0): N,R*T,pi,time,ranks=R  (+ columnas de HPC_MC_TARGET/SAMPLER)
+ */
+
+typedef struct { uint64_t seed; int mode, samp; } dart_ctx_t;
+
+// Aciertos de [a,b) con HPC_MC_SAMPLER repartido entre los hilos del rank
+// (tramos alineados a bloques); el dardo iid lo cuenta el motor
+static void dart_range(uint64_t a, uint64_t b, uint64_t acc[2], const void* ctx){
+    const dart_ctx_t* c = (const dart_ctx_t*)ctx;
+    uint64_t in = 0;
+    #pragma omp parallel reduction(+:in)
+    {
+        uint64_t x, y;
+        mc_mpi_subrange(a, b, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &x, &y);
+        in += mc_dart_count_sampler(c->samp, c->seed, x, y);
+    }
+    acc[0] += in;
+    acc[1] += b - a;
+}
+
+int main(int argc, char** argv){
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    uint64_t N = (argc > 1)? strtoull(argv[1], NULL, 10) : (uint64_t)100000000;
+    // HPC_MPI_WEAK=1: N es por rank (escalamiento débil); total = N * R
+    if (mc_mpi_weak_from_env()) N *= (uint64_t)size;
+
+    // semilla del flujo reproducible (3er arg opcional): misma que _seq y _omp
+    dart_ctx_t ctx;
+    ctx.seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+    ctx.mode = mc_dart_mode_from_env();
+    int prec = mc_prec_from_env();   // validado junto con mode
+    ctx.samp = mc_sampler_from_env();
+    double target = mc_target_from_env();
+    if (ctx.mode < 0 || ctx.samp < 0 || (ctx.samp != MC_SAMPLER_IID && target > 0.0)){
+        MPI_Finalize();
+        return 3;
+    }
+
+    // iid: mc_engine_dart_mode (mismo conteo que mc_dart_count_stream en cada modo)
+    mc_engine_dart_mode_p dp = { ctx.mode };
+    mc_engine_job_t job = { ctx.seed, &dp };
+
+    uint64_t tot[2];   // aciertos, muestras (válidos en rank 0)
+    MPI_Barrier(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    if (target > 0.0) {   // solo iid
+        mc_mpi_run_target(N, target, MC_EST_DART, 1.0, mc_engine_dart_mode_range_omp, &job,
+                          MPI_COMM_WORLD, tot, NULL);
+    } else if (ctx.samp != MC_SAMPLER_IID) {
+        mc_mpi_run(N, dart_range, &ctx, MPI_COMM_WORLD, tot);
+    } else {
+        mc_acc_t acc;
+        mc_engine_dart_mode_run_mpi(ctx.seed, N, &dp, MPI_COMM_WORLD, &acc);
+        tot[0] = acc.hits;
+        tot[1] = acc.n;
+    }
+    double t1 = MPI_Wtime();
+
+    if (rank == 0){
+        int threads = size * omp_get_max_threads();
+        double pi = 4.0 * (double)tot[0] / (double)tot[1];
+        const char* out_path = (argc > 2)? argv[2] : NULL;
+        FILE* f = out_path ? fopen(out_path, "a") : NULL;
+        if (f){
+            fprintf(f, "%llu,%d,%.9f,%.6f,ranks=%d",
+                    (unsigned long long)tot[1], threads, pi, (t1 - t0), size);
+            if (target > 0.0) mc_mpi_report(f, MC_EST_DART, tot, target, 1.0);
+            if (ctx.samp != MC_SAMPLER_IID) fprintf(f, ",sampler=%s", mc_sampler_name(ctx.samp));
+            if (prec != MC_PREC_AUTO) fprintf(f, ",prec=%s", mc_prec_name(prec));
+            fprintf(f, "\n");
+            fclose(f);
+        }
+    }
+    MPI_Finalize();
+    return 0;
+}
@@ -1,26 +1,16 @@
 #define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
 #include <omp.h>
-
-/* RNG xorshift64* */
-static inline uint64_t splitmix64(uint64_t x){
-    x += 0x9e3779b97f4a7c15ULL;
-    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
-    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
-    return x ^ (x >> 31);
-}
-typedef struct { uint64_t s; } xrng_t;
-static inline void xrng_seed(xrng_t* r, uint64_t seed){ r->s = splitmix64(seed); }
-static inline uint64_t xorshift64s(xrng_t* r){
-    uint64_t x = r->s; x ^= x >> 12; x ^= x << 25; x ^= x >> 27; r->s = x;
-    return x * 0x2545F4914F6CDD1DULL;
-}
-static inline double xrng_uniform01(xrng_t* r){
-    return (xorshift64s(r) >> 11) * (1.0/9007199254740992.0);
-}
+#include "../common/mc_kernels.h"   // xoshiro256+ de 8 carriles + kernels por bloques
+#include "../common/mc_adaptive.h"  // HPC_MC_TARGET: parar al llegar al error objetivo
+#include "../common/mc_sampler.h"   // HPC_MC_SAMPLER: estratificado, antitético, Sobol/Halton
+#include "../common/mc_state.h"     // HPC_MC_STATE: archivo de estado, corridas reanudables
+#include "../common/mc_engine.h"    // dardo iid con N fijo: backend OpenMP del motor
+#include "../common/affinity.h"
 
 /* timer */
 static inline double now_sec(void){
@@ -28,43 +18,128 @@ static inline double now_sec(void){
     return ts.tv_sec + ts.tv_nsec*1e-9;
 }
 
+typedef struct { uint64_t seed; int mode, samp; } dart_ctx_t;
+
+// Aciertos de [a,b) repartido entre los hilos (tramos alineados a bloques)
+static void dart_range(uint64_t a, uint64_t b, uint64_t acc[2], const void* ctx){
+    const dart_ctx_t* c = (const dart_ctx_t*)ctx;
+    uint64_t in = 0;
+    #pragma omp parallel reduction(+:in)
+    {
+        uint64_t x, y;
+        mc_stream_split(b - a, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &x, &y);
+        in += c->samp == MC_SAMPLER_IID ? mc_dart_count_stream(c->seed, a + x, a + y, c->mode)
+                                        : mc_dart_count_sampler(c->samp, c->seed, a + x, a + y);
+    }
+    acc[0] += in;
+    acc[1] += b - a;
+}
+
 int main(int argc, char** argv){
     uint64_t N = (argc > 1)? strtoull(argv[1], NULL, 10) : (uint64_t)100000000;
 
     uint64_t in = 0;
     int threads = 1;
 
+    // semilla del flujo reproducible (3er arg opcional): misma en _seq y _omp
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+
+    // dardo: HPC_DART=int (defecto, 1 valor de 64 bits por dardo) | double | float
+    // (o HPC_MC_PREC=double|float)
+    int mode = mc_dart_mode_from_env();
+    int prec = mc_prec_from_env();   // validado junto con mode
+    if (mode < 0) return 3;
+
+    // HPC_MC_TARGET=<se>: N pasa a ser el presupuesto máximo (ver mc_adaptive.h)
+    double target = mc_target_from_env();
+
+    // HPC_MC_SAMPLER=iid (defecto) | strat | anti | sobol | halton. Fuera de iid
+    // el error binomial no aplica: no se combina con HPC_MC_TARGET
+    int samp = mc_sampler_from_env();
+    if (samp < 0 || (samp != MC_SAMPLER_IID && target > 0.0)) return 3;
+    mc_adapt_t ad;
+    mc_adapt_init(&ad, N, target, MC_EST_DART, 1.0);
+
+    // HPC_MC_STATE=<archivo>: guarda/continúa la corrida; N es el total
+    // acumulado del flujo (ver mc_state.h)
+    const char* state_path = mc_state_path_from_env();
+    mc_state_t st;
+    uint64_t pos0 = 0;
+    if (state_path) {
+        mc_state_init(&st, MC_EST_DART, seed, mode, samp, 1.0);
+        if (mc_state_load(state_path, &st) < 0) return 4;
+        pos0 = st.pos;
+    }
+
+    // Afinidad opcional (HPC_AFFINITY=compact|scatter|cores|list:...): cada hilo
+    // del pool OpenMP se fija una vez, fuera de la medición; libgomp reutiliza
+    // los mismos hilos en las regiones paralelas siguientes
+    affinity_t aff;
+    if (affinity_from_env(&aff, omp_get_max_threads())) {
+        #pragma omp parallel
+        affinity_pin_thread(&aff, omp_get_thread_num());
+    }
+
     double t0 = now_sec();
-    #pragma omp parallel
-    {
-        xrng_t R;
-        uint64_t seed = 0x9e3779b97f4a7c15ULL
-                      ^ (uint64_t)omp_get_thread_num()
-                      ^ (uint64_t)(uintptr_t)&R
-                      ^ (uint64_t)time(NULL);
-        xrng_seed(&R, seed);
+    int state_err = 0;
+    if (state_path) {
+        // rondas del flujo; cada ronda se reparte entre los hilos en dart_range
+        // (ya fijados arriba: las rondas no vuelven a fijar)
+        dart_ctx_t ctx = { seed, mode, samp };
+        state_err = mc_state_run(&st, N, target, dart_range, &ctx,
+                                 state_path, mc_state_interval_from_env());
+        in = st.hits;
+        threads = omp_get_max_threads();
+    } else if (target == 0.0 && samp == MC_SAMPLER_IID) {
+        // tramo alineado a bloques del flujo por hilo (NAME_run_omp): la muestra i
+        // usa siempre los mismos números, así el resultado no depende del número de hilos
+        mc_engine_dart_mode_p dp = { mode };
+        mc_acc_t acc;
+        mc_engine_dart_mode_run_omp(seed, N, &dp, &acc);
+        in = acc.hits;
+        threads = omp_get_max_threads();
+    } else {
+        #pragma omp parallel reduction(+:in)
+        {
+            uint64_t a, b;
+            if (target > 0.0) {
+                // lotes en orden desde un contador atómico hasta llegar al objetivo
+                while (mc_adapt_claim(&ad, &a, &b))
+                    mc_adapt_publish(&ad, mc_dart_count_stream(seed, a, b, mode), b - a);
+            } else {
+                // HPC_MC_SAMPLER: mismo reparto por tramos alineados a bloques
+                mc_stream_split(N, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &a, &b);
+                in += mc_dart_count_sampler(samp, seed, a, b);
+            }
 
-        #pragma omp for schedule(static) reduction(+:in)
-        for (uint64_t i=0;i<N;i++){
-            double x = xrng_uniform01(&R);
-            double y = xrng_uniform01(&R);
-            if (x*x + y*y <= 1.0) in++;
+            #pragma omp master
+            { threads = omp_get_num_threads(); }
         }
-
-        #pragma omp master
-        { threads = omp_get_num_threads(); }
     }
     double t1 = now_sec();
+    if (state_path) N = st.n;                         // total acumulado
+    else if (target > 0.0) { in = ad.hits; N = ad.n; }   // N = muestras usadas
 
     double pi = 4.0 * (double)in / (double)N;
     const char* out_path = (argc > 2)? argv[2] : NULL;
     if (out_path){
         FILE* f = fopen(out_path, "a");
         if (f){
-            fprintf(f, "%llu,%d,%.9f,%.6f\n",
+            fprintf(f, "%llu,%d,%.9f,%.6f",
                     (unsigned long long)N, threads, pi, (t1 - t0));
+            if (state_path) mc_state_report(f, &st, pos0, target);
+            else if (target > 0.0) mc_adapt_report(f, &ad);
+            if (samp != MC_SAMPLER_IID) fprintf(f, ",sampler=%s", mc_sampler_name(samp));
+            if (prec != MC_PREC_AUTO) fprintf(f, ",prec=%s", mc_prec_name(prec));
+            // columna extra solo con afinidad: awk de run_omp.sh lee $1..$4
+            if (aff.enabled) {
+                char buf[512];
+                fprintf(f, ",%s", affinity_format(&aff, buf, sizeof buf, ';'));
+            }
+            fprintf(f, "\n");
             fclose(f);
         }
     }
-    return 0;
+    affinity_release(&aff);
+    return state_err ? 4 : 0;
 }
@@ -3,23 +3,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
-
-/* RNG xorshift64* */
-static inline uint64_t splitmix64(uint64_t x){
-    x += 0x9e3779b97f4a7c15ULL;
-    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
-    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
-    return x ^ (x >> 31);
-}
-typedef struct { uint64_t s; } xrng_t;
-static inline void xrng_seed(xrng_t* r, uint64_t seed){ r->s = splitmix64(seed); }
-static inline uint64_t xorshift64s(xrng_t* r){
-    uint64_t x = r->s; x ^= x >> 12; x ^= x << 25; x ^= x >> 27; r->s = x;
-    return x * 0x2545F4914F6CDD1DULL;
-}
-static inline double xrng_uniform01(xrng_t* r){
-    return (xorshift64s(r) >> 11) * (1.0/9007199254740992.0);
-}
+#include "../common/mc_kernels.h"   // xoshiro256+ de 8 carriles + kernels por bloques
+#include "../common/mc_adaptive.h"  // HPC_MC_TARGET: parar al llegar al error objetivo
+#include "../common/mc_sampler.h"   // HPC_MC_SAMPLER: estratificado, antitético, Sobol/Halton
+#include "../common/mc_state.h"     // HPC_MC_STATE: archivo de estado, corridas reanudables
 
 /* timer */
 static inline double now_sec(void){
@@ -27,18 +14,67 @@ static inline double now_sec(void){
     return ts.tv_sec + ts.tv_nsec*1e-9;
 }
 
+typedef struct { uint64_t seed; int mode, samp; } dart_ctx_t;
+
+static void dart_range(uint64_t a, uint64_t b, uint64_t acc[2], const void* ctx){
+    const dart_ctx_t* c = (const dart_ctx_t*)ctx;
+    acc[0] += c->samp == MC_SAMPLER_IID ? mc_dart_count_stream(c->seed, a, b, c->mode)
+                                        : mc_dart_count_sampler(c->samp, c->seed, a, b);
+    acc[1] += b - a;
+}
+
 int main(int argc, char** argv){
     uint64_t N = (argc > 1)? strtoull(argv[1], NULL, 10) : (uint64_t)100000000;
     const int threads = 1;  /* serial */
 
-    xrng_t R; xrng_seed(&R, 123456789ULL);
-    uint64_t in = 0;
+    // semilla del flujo reproducible (3er arg opcional): misma en _seq y _omp
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+
+    // dardo: HPC_DART=int (defecto, 1 valor de 64 bits por dardo) | double | float
+    // (o HPC_MC_PREC=double|float)
+    int mode = mc_dart_mode_from_env();
+    int prec = mc_prec_from_env();   // validado junto con mode
+    if (mode < 0) return 3;
+
+    // HPC_MC_TARGET=<se>: N pasa a ser el presupuesto máximo (ver mc_adaptive.h)
+    double target = mc_target_from_env();
+
+    // HPC_MC_SAMPLER=iid (defecto) | strat | anti | sobol | halton. Fuera de iid
+    // el error binomial no aplica: no se combina con HPC_MC_TARGET
+    int samp = mc_sampler_from_env();
+    if (samp < 0 || (samp != MC_SAMPLER_IID && target > 0.0)) return 3;
+    mc_adapt_t ad;
+    mc_adapt_init(&ad, N, target, MC_EST_DART, 1.0);
+
+    // HPC_MC_STATE=<archivo>: guarda/continúa la corrida; N es el total
+    // acumulado del flujo (ver mc_state.h)
+    const char* state_path = mc_state_path_from_env();
+    mc_state_t st;
+    uint64_t pos0 = 0;
+    if (state_path) {
+        mc_state_init(&st, MC_EST_DART, seed, mode, samp, 1.0);
+        if (mc_state_load(state_path, &st) < 0) return 4;
+        pos0 = st.pos;
+    }
 
     double t0 = now_sec();
-    for(uint64_t i=0;i<N;i++){
-        double x = xrng_uniform01(&R);
-        double y = xrng_uniform01(&R);
-        if (x*x + y*y <= 1.0) in++;
+    uint64_t in;
+    int state_err = 0;
+    if (state_path) {
+        dart_ctx_t ctx = { seed, mode, samp };
+        state_err = mc_state_run(&st, N, target, dart_range, &ctx,
+                                 state_path, mc_state_interval_from_env());
+        in = st.hits;
+        N  = st.n;   // total acumulado
+    } else if (target > 0.0) {
+        uint64_t a, b;
+        while (mc_adapt_claim(&ad, &a, &b))
+            mc_adapt_publish(&ad, mc_dart_count_stream(seed, a, b, mode), b - a);
+        in = ad.hits;
+        N  = ad.n;   // muestras usadas
+    } else {
+        in = samp == MC_SAMPLER_IID ? mc_dart_count_stream(seed, 0, N, mode)
+                                    : mc_dart_count_sampler(samp, seed, 0, N);
     }
     double t1 = now_sec();
 
@@ -47,10 +83,15 @@ int main(int argc, char** argv){
     if (out_path){
         FILE* f = fopen(out_path, "a");
         if (f){
-            fprintf(f, "%llu,%d,%.9f,%.6f\n",
+            fprintf(f, "%llu,%d,%.9f,%.6f",
                     (unsigned long long)N, threads, pi, (t1 - t0));
+            if (state_path) mc_state_report(f, &st, pos0, target);
+            else if (target > 0.0) mc_adapt_report(f, &ad);
+            if (samp != MC_SAMPLER_IID) fprintf(f, ",sampler=%s", mc_sampler_name(samp));
+            if (prec != MC_PREC_AUTO) fprintf(f, ",prec=%s", mc_prec_name(prec));
+            fprintf(f, "\n");
             fclose(f);
         }
     }
-    return 0;
+    return state_err ? 4 : 0;
 }
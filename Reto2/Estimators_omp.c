@@ -0,0 +1,71 @@
+#define _POSIX_C_SOURCE 200809L
+/* Estimators_omp: estimadores de pi definidos con el motor genérico (mc_engine.h)
+ *
+ * Cada estimador es un kernel + una línea MC_DEFINE_*_ESTIMATOR; el motor
+ * pone bloques, RNG SIMD, flujo reproducible, OpenMP y estadística.
+ *
+ * Uso: ./Estimators_omp N outfile [seed]
+ * Salida (append), una línea por estimador:
+ *   estimador,N,threads,pi,se,time
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "../common/mc_engine.h"
+
+typedef struct {
+    const char *name;
+    double pi, se, sec;
+} result_t;
+
+static void report(FILE* f, uint64_t N, int threads, const result_t* r){
+    fprintf(f, "%s,%llu,%d,%.9f,%.3e,%.6f\n",
+            r->name, (unsigned long long)N, threads, r->pi, r->se, r->sec);
+}
+
+int main(int argc, char** argv){
+    uint64_t N = (argc > 1)? strtoull(argv[1], NULL, 10) : (uint64_t)100000000;
+    const char* out_path = (argc > 2)? argv[2] : NULL;
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+    if (N == 0) return 3;
+
+    int threads = omp_get_max_threads();
+    result_t res[3];
+    mc_acc_t acc;
+    double t0;
+
+    // dardo: pi = 4 p
+    mc_engine_dart_p dp = { 0 };
+    t0 = omp_get_wtime();
+    mc_engine_dart_run_omp(seed, N, &dp, &acc);
+    res[0].sec  = omp_get_wtime() - t0;
+    res[0].name = "dart";
+    res[0].pi   = 4.0 * mc_engine_dart_mean(&acc);
+    res[0].se   = 4.0 * mc_engine_dart_stderr(&acc);
+
+    // Buffon (L = D = 1): pi = 2 / p, se por método delta
+    mc_engine_buffon_p bp = { 0.5, 0.5 };
+    t0 = omp_get_wtime();
+    mc_engine_buffon_run_omp(seed, N, &bp, &acc);
+    res[1].sec  = omp_get_wtime() - t0;
+    double p = mc_engine_buffon_mean(&acc);
+    res[1].name = "buffon";
+    res[1].pi   = p > 0.0 ? 2.0 / p : 0.0;
+    res[1].se   = p > 0.0 ? 2.0 / (p * p) * mc_engine_buffon_stderr(&acc) : 0.0;
+
+    // integral de 4/(1+x^2) en [0,1]
+    mc_engine_atan_p ap = { 0 };
+    t0 = omp_get_wtime();
+    mc_engine_atan_run_omp(seed, N, &ap, &acc);
+    res[2].sec  = omp_get_wtime() - t0;
+    res[2].name = "atan";
+    res[2].pi   = mc_engine_atan_mean(&acc);
+    res[2].se   = mc_engine_atan_stderr(&acc);
+
+    FILE* f = out_path ? fopen(out_path, "a") : stdout;
+    if (!f) return 7;
+    for (int i = 0; i < 3; ++i) report(f, N, threads, &res[i]);
+    if (f != stdout) fclose(f);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200809L
+/* Prec_check: costo y sesgo de los kernels en float frente a double (mc_kernels.h)
+ *
+ * Por kernel (dart, buffon con seno poly):
+ *   float_s / double_s    tiempo de [0,N) del flujo reproducible en cada precisión
+ *   pi_float / pi_double  estimaciones (muestras distintas: float usa la mitad
+ *                         de bits aleatorios por muestra)
+ *   z                     (pi_float - pi_double) / error estándar combinado;
+ *                         |z| < 2 es lo esperable si el sesgo de float no se ve
+ *   flips                 pareado: las MISMAS muestras float evaluadas con
+ *                         aritmética float y double; muestras cuyo test cambia
+ *   bias                  sesgo de pi por la aritmética float (neto de flips)
+ *   grid_bias             sesgo de pi del punto izquierdo de la malla k/2^23
+ *                         frente al punto medio (MC_MID_F); el dardo usa el
+ *                         medio, Buffon el izquierdo (su sesgo es ~2e-8)
+ *
+ * Uso: ./Prec_check N outfile [seed]
+ * Salida (append), una línea por kernel:
+ *   kind=<k> N=<N> float_s=<s> double_s=<s> speedup=<x> pi_float=<pi> pi_double=<pi>
+ *     z=<z> flips=<n> bias=<b> grid_bias=<b>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "../common/mc_kernels.h"
+#include "../common/mc_adaptive.h"
+
+static inline double now_sec(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// Dardo pareado sobre las muestras float del kernel: aciertos con el test en
+// float (el del kernel), en double y en double con el punto izquierdo
+static void dart_paired(uint64_t seed, uint64_t N, int64_t *arith, int64_t *grid, uint64_t *flips){
+    _Alignas(64) float x[XR_BLOCK], y[XR_BLOCK];
+    xr_simd_t r;
+    xr_simd_seed(&r, seed);
+    int64_t da = 0, dg = 0;
+    uint64_t fl = 0;
+    for (uint64_t done = 0; done < N; done += XR_BLOCK){
+        xr_simd_fill01f(&r, x, XR_BLOCK);
+        xr_simd_fill01f(&r, y, XR_BLOCK);
+        size_t m = N - done < XR_BLOCK ? (size_t)(N - done) : XR_BLOCK;
+        for (size_t i = 0; i < m; ++i){
+            float xf = MC_MID_F(x[i]), yf = MC_MID_F(y[i]);
+            int hf = xf*xf <= 1.0f - yf*yf;      // mismo test que el kernel
+            int hd = (double)xf*xf + (double)yf*yf <= 1.0;
+            int hl = (double)x[i]*x[i] + (double)y[i]*y[i] <= 1.0;
+            da += hf - hd;
+            dg += hl - hd;
+            fl += hf != hd;
+        }
+    }
+    *arith = da; *grid = dg; *flips = fl;
+}
+
+// Buffon pareado: mismo (theta, y) en float; mc_sinf_poly en float (el test del
+// kernel) contra sin() en double, y el punto izquierdo (el kernel) contra el medio
+static void buffon_paired(uint64_t seed, uint64_t N, int64_t *arith, int64_t *grid,
+                          uint64_t *flips, uint64_t *hits_d){
+    _Alignas(64) float th[XR_BLOCK], y[XR_BLOCK];
+    xr_simd_t r;
+    xr_simd_seed(&r, seed);
+    int64_t da = 0, dg = 0;
+    uint64_t fl = 0, hd_sum = 0;
+    for (uint64_t done = 0; done < N; done += XR_BLOCK){
+        xr_simd_fill01f(&r, th, XR_BLOCK);
+        xr_simd_fill01f(&r, y, XR_BLOCK);
+        size_t m = N - done < XR_BLOCK ? (size_t)(N - done) : XR_BLOCK;
+        for (size_t i = 0; i < m; ++i){
+            int hf = 0.5f * y[i] <= 0.5f * mc_sinf_poly((float)MC_PI_HALF * th[i]);
+            int hd = 0.5 * y[i] <= 0.5 * sin(MC_PI_HALF * (double)th[i]);
+            float tm = MC_MID_F(th[i]), ym = MC_MID_F(y[i]);
+            int hm = 0.5 * ym <= 0.5 * sin(MC_PI_HALF * (double)tm);
+            da += hf - hd;
+            dg += hd - hm;
+            fl += hf != hd;
+            hd_sum += hd;
+        }
+    }
+    *arith = da; *grid = dg; *flips = fl; *hits_d = hd_sum;
+}
+
+int main(int argc, char** argv){
+    if (argc < 3) return 2;
+    uint64_t N = strtoull(argv[1], NULL, 10);
+    const char* out_path = argv[2];
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+    if (N == 0) return 3;
+
+    FILE* f = fopen(out_path, "a");
+    if (!f) return 7;
+
+    // ---- dardo ----
+    double t0 = now_sec();
+    uint64_t cf = mc_dart_count_stream(seed, 0, N, MC_DART_FLOAT);
+    double t1 = now_sec();
+    uint64_t cd = mc_dart_count_stream(seed, 0, N, MC_DART_DOUBLE);
+    double t2 = now_sec();
+    int64_t arith, grid;
+    uint64_t flips;
+    dart_paired(seed, N, &arith, &grid, &flips);
+    double pf = mc_pi_estimate(MC_EST_DART, cf, N, 1.0), pd = mc_pi_estimate(MC_EST_DART, cd, N, 1.0);
+    double se = hypot(mc_pi_stderr(MC_EST_DART, cf, N, 1.0), mc_pi_stderr(MC_EST_DART, cd, N, 1.0));
+    fprintf(f, "kind=dart N=%llu float_s=%.6f double_s=%.6f speedup=%.2f pi_float=%.9f pi_double=%.9f "
+               "z=%.2f flips=%llu bias=%.3e grid_bias=%.3e\n",
+            (unsigned long long)N, t1 - t0, t2 - t1, (t2 - t1) / (t1 - t0), pf, pd,
+            (pf - pd) / se, (unsigned long long)flips,
+            4.0 * (double)arith / (double)N, 4.0 * (double)grid / (double)N);
+
+    // ---- buffon (L = D = 1, seno poly) ----
+    uint64_t nf = 0, nd = 0;
+    t0 = now_sec();
+    cf = mc_buffon_count_stream_m(seed, 0, N, 1.0, 1.0, MC_SIN_POLY, &nf);
+    t1 = now_sec();
+    cd = mc_buffon_count_stream_m(seed, 0, N, 1.0, 1.0, MC_SIN_POLY | MC_BUFFON_DOUBLE, &nd);
+    t2 = now_sec();
+    uint64_t hits_d;
+    buffon_paired(seed, N, &arith, &grid, &flips, &hits_d);
+    pf = mc_pi_estimate(MC_EST_BUFFON, cf, nf, 1.0);
+    pd = mc_pi_estimate(MC_EST_BUFFON, cd, nd, 1.0);
+    se = hypot(mc_pi_stderr(MC_EST_BUFFON, cf, nf, 1.0), mc_pi_stderr(MC_EST_BUFFON, cd, nd, 1.0));
+    // pi = 2N / cruces: d(pi) = -pi d(cruces) / cruces
+    double pd_paired = mc_pi_estimate(MC_EST_BUFFON, hits_d, N, 1.0);
+    fprintf(f, "kind=buffon N=%llu float_s=%.6f double_s=%.6f speedup=%.2f pi_float=%.9f pi_double=%.9f "
+               "z=%.2f flips=%llu bias=%.3e grid_bias=%.3e\n",
+            (unsigned long long)N, t1 - t0, t2 - t1, (t2 - t1) / (t1 - t0), pf, pd,
+            (pf - pd) / se, (unsigned long long)flips,
+            hits_d ? -pd_paired * (double)arith / (double)hits_d : 0.0,
+            hits_d ? -pd_paired * (double)grid / (double)hits_d : 0.0);
+    fclose(f);
+    return 0;
+}
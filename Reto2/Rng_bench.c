@@ -0,0 +1,396 @@
+#define _POSIX_C_SOURCE 200809L
+/* Rng_bench: velocidad y calidad de los generadores de números aleatorios
+ *
+ * Generadores (salida de 64 bits):
+ *   xorshift64s_a   xorshift64* con multiplicador 2685821657736338717
+ *                   (rand01 de Reto1/common.h)
+ *   xorshift64s_b   xorshift64* con 0x2545F4914F6CDD1D y semilla splitmix64
+ *                   (el que usaba Reto2 antes de rng_simd.h)
+ *   splitmix64      contador + mezcla (xr_splitmix64, siembra de rng_simd.h)
+ *   xoshiro256p     xoshiro256+ escalar (un carril de rng_simd.h)
+ *   xoshiro256p_x8  rng_simd.h tal cual: 8 carriles intercalados (lo que
+ *                   consumen los kernels)
+ *   pcg64           PCG XSL-RR 128/64 (O'Neill 2014)
+ *   philox4x32      Philox4x32-10 de rng_stream.h en modo contador (2 salidas
+ *                   de 64 bits por llamada)
+ *   lcg64_ctl       LCG de 64 bits sin mezclar (MMIX): CONTROL, sus bits bajos
+ *                   son periódicos; la batería debe rechazarlo
+ *
+ * Velocidad (ns por valor de 64 bits, un hilo):
+ *   scalar_ns  una llamada por valor, sumando la salida (cadena del generador)
+ *   batch_ns   bloques de RB_BATCH valores con 8 instancias independientes
+ *              intercaladas (vectorizable / paralelismo de instrucción);
+ *              xoshiro256p_x8 usa xr_simd_fill_u64
+ *
+ * Batería rápida (sobre la secuencia escalar; N valores por prueba), p-valor
+ * bilateral: un chi-cuadrado demasiado bueno también es sospechoso.
+ *   chi2_hi   16 bits altos en 2^16 celdas
+ *   chi2_lo   16 bits bajos en 2^16 celdas
+ *   pairs     pares consecutivos (8 bits altos, 8 bits altos) en 2^16 celdas
+ *   gap       prueba de huecos de Knuth: longitudes entre visitas a [0,1/8)
+ *   bday_hi   espaciamientos de cumpleaños de Marsaglia: m = 512 días en un
+ *             año de 2^24 (24 bits altos); repeticiones ~ Poisson(2)
+ *   bday_lo   igual con los 24 bits bajos
+ *   bits      frecuencia de unos de cada uno de los 64 bits (Bonferroni)
+ * verdict: fail si algún p < 1e-6, suspect si algún p < 1e-3, si no pass.
+ * Es un filtro rápido de defectos gruesos (bits bajos, mala mezcla), no
+ * sustituye a TestU01/PractRand: xoshiro256+ pasa aquí aunque sus 2-3 bits
+ * bajos fallen pruebas de complejidad lineal (por eso los kernels usan los
+ * bits altos).
+ *
+ * Uso: ./Rng_bench N outfile [seed]
+ * Salida (append), una línea por generador y al final la recomendación:
+ *   gen=<g> N=<N> scalar_ns=<t> batch_ns=<t> chi2_hi=<p> chi2_lo=<p> pairs=<p>
+ *     gap=<p> bday_hi=<p> bday_lo=<p> bits=<p> verdict=<pass|suspect|fail>
+ *   best=<generador pass con menor batch_ns> batch_ns=<t>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "../common/rng_simd.h"
+#include "../common/rng_stream.h"
+
+#define RB_BATCH  4096          // valores por bloque (en L1: 32 KB)
+#define RB_LANES  8             // instancias intercaladas en batch_ns
+#define RB_TIME_N (1u << 27)    // valores por medición de velocidad
+
+static inline double now_sec(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static volatile uint64_t rb_sink;    // evita que se eliminen los bucles medidos
+
+// ---- generadores: <g>_t, <g>_seed(g, s), <g>_next(g) ----
+typedef struct { uint64_t s; } xorshift64s_a_t;
+static inline void xorshift64s_a_seed(xorshift64s_a_t *g, uint64_t s){ g->s = s ? s : 1; }
+static inline uint64_t xorshift64s_a_next(xorshift64s_a_t *g){
+    uint64_t x = g->s;
+    x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+    g->s = x;
+    return x * 2685821657736338717ULL;
+}
+
+typedef struct { uint64_t s; } xorshift64s_b_t;
+static inline void xorshift64s_b_seed(xorshift64s_b_t *g, uint64_t s){
+    g->s = xr_splitmix64(&s);
+    if (!g->s) g->s = 1;
+}
+static inline uint64_t xorshift64s_b_next(xorshift64s_b_t *g){
+    uint64_t x = g->s;
+    x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+    g->s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+typedef struct { uint64_t s; } splitmix64_t;
+static inline void splitmix64_seed(splitmix64_t *g, uint64_t s){ g->s = s; }
+static inline uint64_t splitmix64_next(splitmix64_t *g){ return xr_splitmix64(&g->s); }
+
+typedef struct { uint64_t s[4]; } xoshiro256p_t;
+static inline void xoshiro256p_seed(xoshiro256p_t *g, uint64_t s){
+    for (int k = 0; k < 4; ++k) g->s[k] = xr_splitmix64(&s);
+}
+static inline uint64_t xoshiro256p_next(xoshiro256p_t *g){
+    uint64_t *s = g->s;
+    uint64_t r = s[0] + s[3], t = s[1] << 17;
+    s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+    s[2] ^= t; s[3] = (s[3] << 45) | (s[3] >> 19);
+    return r;
+}
+
+// rng_simd.h consumido valor a valor desde un bloque (orden intercalado de carriles)
+typedef struct { xr_simd_t r; _Alignas(64) uint64_t buf[XR_BLOCK]; size_t i; } xoshiro256p_x8_t;
+static inline void xoshiro256p_x8_seed(xoshiro256p_x8_t *g, uint64_t s){
+    xr_simd_seed(&g->r, s);
+    g->i = XR_BLOCK;
+}
+static inline uint64_t xoshiro256p_x8_next(xoshiro256p_x8_t *g){
+    if (g->i == XR_BLOCK){ xr_simd_fill_u64(&g->r, g->buf, XR_BLOCK); g->i = 0; }
+    return g->buf[g->i++];
+}
+
+typedef struct { unsigned __int128 s, inc; } pcg64_t;
+#define PCG64_MULT (((unsigned __int128)0x2360ED051FC65DA4ULL << 64) | 0x4385DF649FCCF645ULL)
+static inline uint64_t pcg64_next(pcg64_t *g){
+    g->s = g->s * PCG64_MULT + g->inc;
+    uint64_t x = (uint64_t)(g->s >> 64) ^ (uint64_t)g->s;
+    unsigned rot = (unsigned)(g->s >> 122);
+    return (x >> rot) | (x << ((64 - rot) & 63));
+}
+static inline void pcg64_seed(pcg64_t *g, uint64_t s){
+    uint64_t a = xr_splitmix64(&s), b = xr_splitmix64(&s);
+    g->s = 0;
+    g->inc = ((unsigned __int128)b << 1) | 1u;
+    pcg64_next(g);
+    g->s += a;
+    pcg64_next(g);
+}
+
+typedef struct { uint64_t ctr; uint32_t key[2]; uint64_t buf[2]; int i; } philox4x32_t;
+static inline void philox4x32_seed(philox4x32_t *g, uint64_t s){
+    g->ctr = 0;
+    g->key[0] = (uint32_t)s;
+    g->key[1] = (uint32_t)(s >> 32);
+    g->i = 2;
+}
+static inline uint64_t philox4x32_next(philox4x32_t *g){
+    if (g->i == 2){
+        uint32_t c[4] = { (uint32_t)g->ctr, (uint32_t)(g->ctr >> 32), 0, 0 };
+        philox4x32_10(c, g->key);
+        g->buf[0] = (uint64_t)c[1] << 32 | c[0];
+        g->buf[1] = (uint64_t)c[3] << 32 | c[2];
+        g->ctr++;
+        g->i = 0;
+    }
+    return g->buf[g->i++];
+}
+
+typedef struct { uint64_t s; } lcg64_ctl_t;
+static inline void lcg64_ctl_seed(lcg64_ctl_t *g, uint64_t s){ g->s = s; }
+static inline uint64_t lcg64_ctl_next(lcg64_ctl_t *g){
+    g->s = g->s * 6364136223846793005ULL + 1442695040888963407ULL;
+    return g->s;
+}
+
+// ---- medición y secuencia para la batería, generadas por generador ----
+// (static inline: xoshiro256p_x8 no usa su G##_batch_ns, ver _fill_ns)
+#define RB_DEFINE(G)                                                          \
+static inline double G##_scalar_ns(uint64_t seed){                            \
+    G##_t g; G##_seed(&g, seed);                                              \
+    uint64_t acc = 0;                                                         \
+    double t0 = now_sec();                                                    \
+    for (uint64_t i = 0; i < RB_TIME_N; ++i) acc += G##_next(&g);             \
+    double t = now_sec() - t0;                                                \
+    rb_sink ^= acc;                                                           \
+    return 1e9 * t / RB_TIME_N;                                               \
+}                                                                             \
+static inline double G##_batch_ns(uint64_t seed){                             \
+    G##_t g[RB_LANES];                                                        \
+    for (int l = 0; l < RB_LANES; ++l) G##_seed(&g[l], seed + (uint64_t)l);   \
+    _Alignas(64) static uint64_t buf[RB_BATCH];                               \
+    uint64_t acc = 0;                                                         \
+    double t0 = now_sec();                                                    \
+    for (uint64_t i = 0; i < RB_TIME_N; i += RB_BATCH){                       \
+        for (size_t j = 0; j < RB_BATCH; j += RB_LANES)                       \
+            for (int l = 0; l < RB_LANES; ++l) buf[j + l] = G##_next(&g[l]);  \
+        acc += buf[i & (RB_BATCH - 1)];                                       \
+    }                                                                         \
+    double t = now_sec() - t0;                                                \
+    rb_sink ^= acc;                                                           \
+    return 1e9 * t / RB_TIME_N;                                               \
+}                                                                             \
+static inline void G##_fill(void *st, uint64_t *out, size_t n){               \
+    G##_t *g = (G##_t *)st;                                                   \
+    for (size_t i = 0; i < n; ++i) out[i] = G##_next(g);                      \
+}                                                                             \
+static inline void G##_init(void *st, uint64_t seed){ G##_seed((G##_t *)st, seed); }
+
+RB_DEFINE(xorshift64s_a)
+RB_DEFINE(xorshift64s_b)
+RB_DEFINE(splitmix64)
+RB_DEFINE(xoshiro256p)
+RB_DEFINE(xoshiro256p_x8)
+RB_DEFINE(pcg64)
+RB_DEFINE(philox4x32)
+RB_DEFINE(lcg64_ctl)
+
+// xoshiro256p_x8 en bloque: la función de rng_simd.h directamente
+static double xoshiro256p_x8_fill_ns(uint64_t seed){
+    xr_simd_t r;
+    xr_simd_seed(&r, seed);
+    _Alignas(64) static uint64_t buf[RB_BATCH];
+    uint64_t acc = 0;
+    double t0 = now_sec();
+    for (uint64_t i = 0; i < RB_TIME_N; i += RB_BATCH){
+        xr_simd_fill_u64(&r, buf, RB_BATCH);
+        acc += buf[i & (RB_BATCH - 1)];
+    }
+    double t = now_sec() - t0;
+    rb_sink ^= acc;
+    return 1e9 * t / RB_TIME_N;
+}
+
+typedef struct {
+    const char *name;
+    double (*scalar_ns)(uint64_t);
+    double (*batch_ns)(uint64_t);
+    void (*init)(void *, uint64_t);
+    void (*fill)(void *, uint64_t *, size_t);
+} rb_gen_t;
+
+#define RB_GEN(G, BATCH) { #G, G##_scalar_ns, BATCH, G##_init, G##_fill }
+static const rb_gen_t GENS[] = {
+    RB_GEN(xorshift64s_a,  xorshift64s_a_batch_ns),
+    RB_GEN(xorshift64s_b,  xorshift64s_b_batch_ns),
+    RB_GEN(splitmix64,     splitmix64_batch_ns),
+    RB_GEN(xoshiro256p,    xoshiro256p_batch_ns),
+    RB_GEN(xoshiro256p_x8, xoshiro256p_x8_fill_ns),
+    RB_GEN(pcg64,          pcg64_batch_ns),
+    RB_GEN(philox4x32,     philox4x32_batch_ns),
+    RB_GEN(lcg64_ctl,      lcg64_ctl_batch_ns),
+};
+#define RB_NGENS (sizeof GENS / sizeof GENS[0])
+
+// ---- batería ----
+// Estado opaco del generador (cabe el mayor: xoshiro256p_x8_t)
+typedef struct { _Alignas(64) unsigned char b[sizeof(xoshiro256p_x8_t)]; } rb_state_t;
+
+// Flujo de valores de un generador en bloques de RB_BATCH
+typedef struct { const rb_gen_t *g; rb_state_t st; uint64_t buf[RB_BATCH]; size_t i; } rb_src_t;
+
+static void rb_src_init(rb_src_t *s, const rb_gen_t *g, uint64_t seed){
+    s->g = g;
+    g->init(&s->st, seed);
+    s->i = RB_BATCH;
+}
+
+static inline uint64_t rb_src_next(rb_src_t *s){
+    if (s->i == RB_BATCH){ s->g->fill(&s->st, s->buf, RB_BATCH); s->i = 0; }
+    return s->buf[s->i++];
+}
+
+// p bilateral de una z normal
+static double p_norm(double z){ return erfc(fabs(z) / sqrt(2.0)); }
+
+// chi-cuadrado con df grande: aproximación de Wilson-Hilferty
+static double p_chi2(double x, double df){
+    double t = (cbrt(x / df) - (1.0 - 2.0 / (9.0 * df))) / sqrt(2.0 / (9.0 * df));
+    return p_norm(t);
+}
+
+static double chi2_cells(const uint64_t *cnt, size_t cells, uint64_t n){
+    double e = (double)n / (double)cells, x = 0.0;
+    for (size_t k = 0; k < cells; ++k){ double d = (double)cnt[k] - e; x += d * d / e; }
+    return p_chi2(x, (double)(cells - 1));
+}
+
+static double test_chi2(rb_src_t *s, uint64_t n, int shift){
+    uint64_t *cnt = calloc(1u << 16, sizeof *cnt);
+    for (uint64_t i = 0; i < n; ++i) cnt[(rb_src_next(s) >> shift) & 0xFFFF]++;
+    double p = chi2_cells(cnt, 1u << 16, n);
+    free(cnt);
+    return p;
+}
+
+static double test_pairs(rb_src_t *s, uint64_t n){
+    uint64_t *cnt = calloc(1u << 16, sizeof *cnt);
+    uint64_t m = n / 2;
+    for (uint64_t i = 0; i < m; ++i){
+        uint64_t a = rb_src_next(s) >> 56, b = rb_src_next(s) >> 56;
+        cnt[a << 8 | b]++;
+    }
+    double p = chi2_cells(cnt, 1u << 16, m);
+    free(cnt);
+    return p;
+}
+
+// Huecos: longitud r >= 0 entre visitas a [0, 1/8); clases 0..GAP_T-1 y cola
+#define GAP_T 64
+static double test_gap(rb_src_t *s, uint64_t n){
+    uint64_t cnt[GAP_T + 1] = {0}, gaps = 0, r = 0;
+    for (uint64_t i = 0; i < n; ++i){
+        if ((rb_src_next(s) >> 61) == 0){ cnt[r < GAP_T ? r : GAP_T]++; gaps++; r = 0; }
+        else r++;
+    }
+    const double p = 0.125;
+    double x = 0.0, q = 1.0;
+    for (int k = 0; k <= GAP_T; ++k){
+        double pk = k < GAP_T ? p * q : q;   // cola: P(r >= GAP_T) = (1-p)^GAP_T
+        double e = pk * (double)gaps, d = (double)cnt[k] - e;
+        x += d * d / e;
+        q *= 1.0 - p;
+    }
+    return p_chi2(x, GAP_T);
+}
+
+static int cmp_u32(const void *a, const void *b){
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Cumpleaños: m = 512, año 2^24, lambda = m^3 / (4 * 2^24) = 2 por repetición;
+// la suma de repeticiones de espaciamientos sobre R repeticiones ~ Poisson(2R)
+#define BDAY_M    512
+#define BDAY_BITS 24
+#define BDAY_MAXR 8192
+static double test_bday(rb_src_t *s, uint64_t n, int low){
+    uint32_t d[BDAY_M], sp[BDAY_M];
+    uint64_t reps = n / BDAY_M, dup = 0;
+    if (reps > BDAY_MAXR) reps = BDAY_MAXR;
+    if (reps == 0) return 1.0;
+    for (uint64_t r = 0; r < reps; ++r){
+        for (int k = 0; k < BDAY_M; ++k){
+            uint64_t v = rb_src_next(s);
+            d[k] = (uint32_t)(low ? v & ((1u << BDAY_BITS) - 1) : v >> (64 - BDAY_BITS));
+        }
+        qsort(d, BDAY_M, sizeof d[0], cmp_u32);
+        sp[0] = d[0];
+        for (int k = 1; k < BDAY_M; ++k) sp[k] = d[k] - d[k - 1];
+        qsort(sp, BDAY_M, sizeof sp[0], cmp_u32);
+        for (int k = 1; k < BDAY_M; ++k) dup += sp[k] == sp[k - 1];
+    }
+    double lam = (double)reps * (double)BDAY_M * BDAY_M * BDAY_M / (4.0 * (double)(1u << BDAY_BITS));
+    return p_norm(((double)dup - lam) / sqrt(lam));
+}
+
+static double test_bits(rb_src_t *s, uint64_t n){
+    uint64_t ones[64] = {0};
+    for (uint64_t i = 0; i < n; ++i){
+        uint64_t v = rb_src_next(s);
+        for (int b = 0; b < 64; ++b) ones[b] += (v >> b) & 1u;
+    }
+    double zmax = 0.0;
+    for (int b = 0; b < 64; ++b){
+        double z = fabs(((double)ones[b] - 0.5 * (double)n) / sqrt(0.25 * (double)n));
+        if (z > zmax) zmax = z;
+    }
+    double p = 64.0 * p_norm(zmax);
+    return p < 1.0 ? p : 1.0;
+}
+
+enum { T_CHI2_HI, T_CHI2_LO, T_PAIRS, T_GAP, T_BDAY_HI, T_BDAY_LO, T_BITS, T_COUNT };
+
+int main(int argc, char** argv){
+    if (argc < 3) return 2;
+    uint64_t N = strtoull(argv[1], NULL, 10);
+    const char* out_path = argv[2];
+    uint64_t seed = (argc > 3)? strtoull(argv[3], NULL, 10) : 123456789ULL;
+    if (N == 0) return 3;
+
+    FILE* f = fopen(out_path, "a");
+    if (!f) return 7;
+    const char* best = NULL;
+    double best_ns = INFINITY;
+    rb_src_t *src = malloc(sizeof *src);
+    if (!src){ fclose(f); return 7; }
+    for (size_t j = 0; j < RB_NGENS; ++j){
+        const rb_gen_t *g = &GENS[j];
+        double sns = g->scalar_ns(seed), bns = g->batch_ns(seed);
+        double p[T_COUNT];
+        // cada prueba con su propia semilla: secuencias independientes
+        rb_src_init(src, g, seed + 1); p[T_CHI2_HI] = test_chi2(src, N, 48);
+        rb_src_init(src, g, seed + 2); p[T_CHI2_LO] = test_chi2(src, N, 0);
+        rb_src_init(src, g, seed + 3); p[T_PAIRS]   = test_pairs(src, N);
+        rb_src_init(src, g, seed + 4); p[T_GAP]     = test_gap(src, N);
+        rb_src_init(src, g, seed + 5); p[T_BDAY_HI] = test_bday(src, N, 0);
+        rb_src_init(src, g, seed + 6); p[T_BDAY_LO] = test_bday(src, N, 1);
+        rb_src_init(src, g, seed + 7); p[T_BITS]    = test_bits(src, N);
+        double pmin = 1.0;
+        for (int t = 0; t < T_COUNT; ++t) if (p[t] < pmin) pmin = p[t];
+        const char* verdict = pmin < 1e-6 ? "fail" : (pmin < 1e-3 ? "suspect" : "pass");
+        if (pmin >= 1e-3 && bns < best_ns){ best = g->name; best_ns = bns; }
+        fprintf(f, "gen=%s N=%llu scalar_ns=%.3f batch_ns=%.3f chi2_hi=%.2e chi2_lo=%.2e pairs=%.2e "
+                   "gap=%.2e bday_hi=%.2e bday_lo=%.2e bits=%.2e verdict=%s\n",
+                g->name, (unsigned long long)N, sns, bns,
+                p[T_CHI2_HI], p[T_CHI2_LO], p[T_PAIRS], p[T_GAP],
+                p[T_BDAY_HI], p[T_BDAY_LO], p[T_BITS], verdict);
+    }
+    if (best) fprintf(f, "best=%s batch_ns=%.3f\n", best, best_ns);
+    free(src);
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#define _POSIX_C_SOURCE 200809L
+/* mc_sampler_bench: error contra tiempo de los muestreadores de mc_sampler.h
+ *
+ * Para cada estimador (dart, buffon), cada muestreador (iid, strat, anti,
+ * sobol, halton) y N = 16384 * 4^k <= Nmax se hacen R réplicas con semillas
+ * distintas (en sobol/halton la semilla cambia la aleatorización de Owen):
+ *
+ *   rmse   raíz del error cuadrático medio contra pi sobre las réplicas
+ *   time   tiempo medio por réplica (OpenMP, tramos [a,b) por hilo)
+ *   cost   rmse^2 * time: costo para una precisión dada, comparable entre
+ *          muestreadores (con O(1/sqrt(N)) es constante en N; más bajo = mejor)
+ *
+ * Uso: ./mc_sampler_bench Nmax outfile [reps] [seed]
+ * Salida (append), una línea por (estimador, muestreador, N):
+ *   kind=<dart|buffon> sampler=<s> N=<N> threads=<T> reps=<R>
+ *     pi=<media> rmse=<e> time=<s> cost=<e>
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include <omp.h>
+#include "../common/mc_sampler.h"
+#include "../common/mc_adaptive.h"   // MC_EST_DART / MC_EST_BUFFON
+
+#define PI_REF 3.14159265358979323846
+
+static inline double now_sec(void){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+// Una corrida de N muestras repartida entre los hilos por tramos del flujo
+static double run_pi(int kind, int samp, uint64_t seed, uint64_t N){
+    uint64_t hits = 0;
+    #pragma omp parallel reduction(+:hits)
+    {
+        uint64_t a, b;
+        mc_stream_split(N, (uint64_t)omp_get_num_threads(), (uint64_t)omp_get_thread_num(), &a, &b);
+        hits += kind == MC_EST_DART ? mc_dart_count_sampler(samp, seed, a, b)
+                                    : mc_buffon_count_sampler(samp, seed, a, b, 1.0, 1.0);
+    }
+    return kind == MC_EST_DART ? 4.0 * (double)hits / (double)N
+                               : (hits ? 2.0 * (double)N / (double)hits : 0.0);
+}
+
+int main(int argc, char** argv){
+    if (argc < 3) return 2;
+    uint64_t Nmax = strtoull(argv[1], NULL, 10);
+    const char* out_path = argv[2];
+    int reps = (argc > 3)? atoi(argv[3]) : 16;
+    uint64_t seed = (argc > 4)? strtoull(argv[4], NULL, 10) : 123456789ULL;
+    if (Nmax < MC_STREAM_BLOCK || reps < 2) return 3;
+
+    FILE* f = fopen(out_path, "a");
+    if (!f) return 7;
+    int threads = omp_get_max_threads();
+    for (int kind = MC_EST_DART; kind <= MC_EST_BUFFON; ++kind){
+        for (int s = 0; s < MC_SAMPLER_COUNT; ++s){
+            for (uint64_t N = MC_STREAM_BLOCK; N <= Nmax; N *= 4){
+                double se2 = 0.0, sum = 0.0, sec = 0.0;
+                for (int r = 0; r < reps; ++r){
+                    double t0 = now_sec();
+                    double pi = run_pi(kind, s, mc_hash64(seed + (uint64_t)r), N);
+                    sec += now_sec() - t0;
+                    sum += pi;
+                    se2 += (pi - PI_REF) * (pi - PI_REF);
+                }
+                double rmse = sqrt(se2 / reps), t = sec / reps;
+                fprintf(f, "kind=%s sampler=%s N=%llu threads=%d reps=%d "
+                           "pi=%.9f rmse=%.3e time=%.6f cost=%.3e\n",
+                        kind == MC_EST_DART ? "dart" : "buffon", mc_sampler_name(s),
+                        (unsigned long long)N, threads, reps,
+                        sum / reps, rmse, t, rmse * rmse * t);
+            }
+        }
+    }
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Compilar primero:
+#   mpicc -O3 -march=native -std=c11 -fopenmp Dart_mpi.c   -o Dart_mpi   -lm
+#   mpicc -O3 -march=native -std=c11 -fopenmp Buffon_mpi.c -o Buffon_mpi -lm
+# Varios nodos: MPIRUN="mpirun --hostfile hosts" ./run_mpi.sh
+
+EXES=( "./Dart_mpi" "./Buffon_mpi" )
+NAMES=( "Dart_mpi"  "Buffon_mpi"  )
+
+PROCS=( 1 2 4 8 )     # ranks
+OMP=1                 # hilos OpenMP por rank
+NS=( 5000000000 )     # fuerte: N total fijo
+NW=( 1000000000 )     # débil: N por rank (HPC_MPI_WEAK=1)
+REPS=5
+
+MPIRUN="${MPIRUN:-mpirun}"
+OUT_DIR="resultados_mpi"
+mkdir -p "$OUT_DIR"
+
+MASTER="$OUT_DIR/resultados_master_mpi.csv"
+echo "programa,escala,N,workers,ranks,rep,pi,time_s" > "$MASTER"
+
+run_suite () {
+  local exe="$1" name="$2" scale="$3" weak="$4"; shift 4
+  local csv="$OUT_DIR/${name}_${scale}.csv"
+  : > "$csv"
+
+  echo ">>> $name ($scale)"
+  for rep in $(seq 1 "$REPS"); do
+    for np in "${PROCS[@]}"; do
+      for n in "$@"; do
+        # el rank 0 APPENDea: N,workers,pi,time_s,ranks=R
+        out_file="$OUT_DIR/tmp_${name}_${scale}_np${np}_rep${rep}.csv"
+        : > "$out_file"
+        HPC_MPI_WEAK="$weak" OMP_NUM_THREADS="$OMP" \
+          $MPIRUN -np "$np" "$exe" "$n" "$out_file"
+        awk -v P="$name" -v S="$scale" -v R="$rep" -F',' \
+            '{sub("ranks=","",$5); print P "," S "," $1 "," $2 "," $5 "," R "," $3 "," $4}' \
+            < "$out_file" >> "$csv"
+        tail -n 1 "$csv" >> "$MASTER"
+      done
+    done
+  done
+  echo ">>> CSV: $csv"
+}
+
+for i in "${!EXES[@]}"; do
+  run_suite "${EXES[$i]}" "${NAMES[$i]}" fuerte 0 "${NS[@]}"
+  run_suite "${EXES[$i]}" "${NAMES[$i]}" debil  1 "${NW[@]}"
+done
+
+echo "OK -> $MASTER"
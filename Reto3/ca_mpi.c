@@ -1,8 +1,14 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <mpi.h>
 #include <unistd.h>  // para access()
+#include "../common/arena.h"
+#include "../common/ca_trace.h"
+
+#define CA_BATCH 64   // pasos por reducción de velocidades (HPC_CA_BATCH)
 
 /**
  * Inicializa la carretera completa (solo en rank 0).
@@ -28,46 +34,68 @@ int count_cars(const int *road, int N) {
 }
 
 /**
- * Calcula el nuevo estado local usando la regla del triplete (L,C,R).
+ * Actualiza las celdas [lo, hi) de road (índices relativos a la primera celda
+ * propia; negativos o >= local_N son fantasmas) en una sola pasada: cada
+ * celda de new_road se escribe una vez y los movimientos se cuentan en el
+ * mismo bucle, sin saltos (lo vectoriza el compilador). Lee road[lo-1] y
+ * road[hi], que deben ser válidos. Devuelve los carros de [lo, hi) que avanzaron.
  */
-void step_local(const int *local_road,
-                int *new_local,
-                int local_N,
-                int left_ghost,
-                int right_ghost,
-                int *local_moves_out)
-{
+int step_range(const int *road, int *new_road, int lo, int hi) {
     int moves = 0;
-
-    // Inicializamos nuevo estado a 0
-    for (int i = 0; i < local_N; ++i) {
-        new_local[i] = 0;
+    for (int i = lo; i < hi; ++i) {
+        int C = road[i], R = road[i + 1];
+        moves += C & (R ^ 1);
+        new_road[i] = C ? R : road[i - 1];
     }
+    return moves;
+}
 
-    // Contar movimientos: un carro se mueve si C==1 y R==0
-    for (int i = 0; i < local_N; ++i) {
-        int C = local_road[i];
-        if (C == 1) {
-            int R = (i == local_N - 1) ? right_ghost : local_road[i + 1];
-            if (R == 0)
-                moves++;
+/**
+ * Velocidades por lotes: cada rank guarda sus movimientos de K pasos y se
+ * reducen juntos con MPI_Ireduce (una reducción cada K pasos en vez de una
+ * bloqueante por paso). Dos lotes alternos: mientras uno viaja se llena el
+ * otro; rank 0 pasa un lote a la traza cuando su reducción termina, antes
+ * de reusarlo.
+ */
+typedef struct {
+    int *moves;          // movimientos locales de los pasos [t0, t0 + count)
+    int *global;         // suma en rank 0
+    int t0, count;
+    int pending;         // hay un MPI_Ireduce en curso
+    MPI_Request req;
+} vel_batch_t;
+
+static void batch_finish(vel_batch_t *b, int rank, int total_cars, ca_trace_t *tr) {
+    if (!b->pending) return;
+    MPI_Wait(&b->req, MPI_STATUS_IGNORE);
+    b->pending = 0;
+    if (rank == 0) {
+        for (int i = 0; i < b->count; ++i) {
+            double v = (total_cars > 0) ? (double)b->global[i] / (double)total_cars : 0.0;
+            ca_trace_push(tr, b->t0 + i, v);
         }
     }
+}
 
-    // Aplicar la regla del triplete para construir new_local
-    for (int i = 0; i < local_N; ++i) {
-        int C = local_road[i];
-        int L = (i == 0) ? left_ghost : local_road[i - 1];
-        int R = (i == local_N - 1) ? right_ghost : local_road[i + 1];
-
-        int new_val = 0;
-        if ((C == 0 && L == 1) || (C == 1 && R == 1))
-            new_val = 1;
-
-        new_local[i] = new_val;
+/**
+ * Anota los movimientos locales del paso t; al cerrar un lote (K pasos o el
+ * último paso) lanza su MPI_Ireduce y pasa al otro lote.
+ */
+static void batch_push(vel_batch_t batch[2], int *cur, int t, int T, int K,
+                       int local_moves, int rank, int total_cars, ca_trace_t *tr) {
+    vel_batch_t *b = &batch[*cur];
+    if (t % K == 0) {
+        batch_finish(b, rank, total_cars, tr);   // el lote de hace 2K pasos
+        b->t0 = t;
+        b->count = 0;
+    }
+    b->moves[b->count++] = local_moves;
+    if (b->count == K || t == T - 1) {
+        MPI_Ireduce(b->moves, b->global, b->count, MPI_INT, MPI_SUM, 0,
+                    MPI_COMM_WORLD, &b->req);
+        b->pending = 1;
+        *cur ^= 1;
     }
-
-    *local_moves_out = moves;
 }
 
 int main(int argc, char **argv) {
@@ -151,14 +179,32 @@ int main(int argc, char **argv) {
         }
     }
 
-    // Arreglos locales
-    int *local_road = (int*)malloc(local_N * sizeof(int));
-    int *new_local  = (int*)malloc(local_N * sizeof(int));
+    // HPC_CA_HALO = profundidad de halo k (defecto 1): se intercambian k
+    // fantasmas por lado y se avanzan k pasos sin comunicar. Los fantasmas
+    // salen de las celdas propias del vecino, así que k <= N / procesos.
+    int depth = 1;
+    const char *henv = getenv("HPC_CA_HALO");
+    if (henv && atoi(henv) > 0) depth = atoi(henv);
+    if (depth > base) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: HPC_CA_HALO=%d mayor que las celdas por proceso (%d).\n",
+                    depth, base);
+        }
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
 
-    if (!local_road || !new_local) {
+    // Arreglos locales: una sola arena con huge pages por rank. Cada buffer
+    // lleva `depth` fantasmas a cada lado; local_road apunta a la celda 0 propia.
+    size_t local_bytes = (size_t)(local_N + 2 * depth) * sizeof(int);
+    arena_t ar;
+    if (!arena_init(&ar, 2 * arena_round_up(local_bytes, ARENA_ALIGN), 0)) {
         fprintf(stderr, "Rank %d: Error al reservar memoria local.\n", rank);
         MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
     }
+    arena_prefault(&ar, 1);  // un rank por núcleo: prefault en el propio rank
+
+    int *local_road = (int*)arena_alloc(&ar, local_bytes) + depth;
+    int *new_local  = (int*)arena_alloc(&ar, local_bytes) + depth;
 
     // Distribuir carretera inicial a todos los procesos
     MPI_Scatterv(global_road, sendcounts, displs, MPI_INT,
@@ -183,49 +229,118 @@ int main(int argc, char **argv) {
         printf("# t\tvelocidad\n");
     }
 
-    double t0 = MPI_Wtime();
+    // Traza de velocidad (ca_trace.h), solo en rank 0: el texto se escribe
+    // al cerrar, fuera de la medición
+    ca_trace_t tr;
+    memset(&tr, 0, sizeof tr);   // CA_TRACE_OFF en los demás ranks
+    if (rank == 0 && ca_trace_open(&tr) != 0) {
+        fprintf(stderr, "Error: no se pudo abrir la traza de velocidad.\n");
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
 
     int left  = (rank - 1 + size) % size;
     int right = (rank + 1) % size;
 
-    for (int t = 0; t < T; ++t) {
-        int left_ghost, right_ghost;
-
-        // Intercambio de halos
-        MPI_Sendrecv(&local_road[0],         1, MPI_INT, left,  0,
-                     &right_ghost,           1, MPI_INT, right, 0,
-                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-        MPI_Sendrecv(&local_road[local_N-1], 1, MPI_INT, right, 1,
-                     &left_ghost,            1, MPI_INT, left,  1,
-                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    // Halos con peticiones persistentes: se crean una vez y cada intercambio
+    // solo hace MPI_Startall. Como local_road cambia de buffer en cada paso,
+    // se envía desde send_edge (copia de las `depth` celdas de cada extremo)
+    // y se recibe en recv_ghost, que luego se copia a los fantasmas.
+    int *halo_mem = (int*)malloc((size_t)4 * depth * sizeof(int));
+    if (!halo_mem) {
+        fprintf(stderr, "Rank %d: Error al reservar memoria local.\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    int *send_left  = halo_mem,             *send_right = halo_mem + depth;
+    int *recv_left  = halo_mem + 2 * depth, *recv_right = halo_mem + 3 * depth;
+    MPI_Request halo[4];
+    MPI_Recv_init(recv_right, depth, MPI_INT, right, 0, MPI_COMM_WORLD, &halo[0]);
+    MPI_Recv_init(recv_left,  depth, MPI_INT, left,  1, MPI_COMM_WORLD, &halo[1]);
+    MPI_Send_init(send_left,  depth, MPI_INT, left,  0, MPI_COMM_WORLD, &halo[2]);
+    MPI_Send_init(send_right, depth, MPI_INT, right, 1, MPI_COMM_WORLD, &halo[3]);
+    size_t halo_bytes = (size_t)depth * sizeof(int);
+
+    // HPC_CA_BATCH = pasos por reducción de velocidades (defecto CA_BATCH)
+    int K = CA_BATCH;
+    const char *kenv = getenv("HPC_CA_BATCH");
+    if (kenv && atoi(kenv) > 0) K = atoi(kenv);
+    if (K > T) K = T;
+    vel_batch_t batch[2];
+    int *batch_mem = (int*)malloc((size_t)4 * K * sizeof(int));
+    if (!batch_mem) {
+        fprintf(stderr, "Rank %d: Error al reservar memoria local.\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    for (int k = 0; k < 2; ++k) {
+        batch[k].moves   = batch_mem + (size_t)(2 * k) * K;
+        batch[k].global  = batch_mem + (size_t)(2 * k + 1) * K;
+        batch[k].pending = 0;
+    }
+    int cur = 0;
 
-        int local_moves = 0;
-        step_local(local_road, new_local, local_N, left_ghost, right_ghost, &local_moves);
+    // Medición: solo los pasos; las reservas y MPI_*_init quedan fuera
+    double t0 = MPI_Wtime();
 
-        int global_moves = 0;
-        MPI_Reduce(&local_moves, &global_moves, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Con la regla 184 la información avanza una celda por paso: con `depth`
+    // fantasmas válidos se pueden dar `depth` pasos, recalculando en cada uno
+    // una franja de fantasmas que se encoge en una celda por lado. Es decir,
+    // depth veces menos mensajes a cambio de ~depth^2 celdas redundantes.
+    for (int t = 0; t < T; t += depth) {
+        int steps = (T - t < depth) ? T - t : depth;
+
+        // Intercambio de halos en vuelo mientras se calcula el interior
+        memcpy(send_left,  local_road,                   halo_bytes);
+        memcpy(send_right, local_road + local_N - depth, halo_bytes);
+        MPI_Startall(4, halo);
+
+        int local_moves = step_range(local_road, new_local, 1, local_N - 1);
+
+        MPI_Waitall(4, halo, MPI_STATUSES_IGNORE);
+        memcpy(local_road - depth,   recv_left,  halo_bytes);
+        memcpy(local_road + local_N, recv_right, halo_bytes);
+
+        // Bordes propios (las celdas 0 y local_N-1) y fantasmas del primer paso
+        local_moves += step_range(local_road, new_local, 0, 1);
+        if (local_N > 1)
+            local_moves += step_range(local_road, new_local, local_N - 1, local_N);
+        step_range(local_road, new_local, 1 - depth, 0);
+        step_range(local_road, new_local, local_N, local_N + depth - 1);
+
+        for (int s = 0; s < steps; ++s) {
+            if (s > 0) {
+                // Paso s sin comunicar: fantasmas válidos en [-depth+s, local_N+depth-s)
+                step_range(local_road, new_local, s + 1 - depth, 0);
+                local_moves = step_range(local_road, new_local, 0, local_N);
+                step_range(local_road, new_local, local_N, local_N + depth - 1 - s);
+            }
+            batch_push(batch, &cur, t + s, T, K, local_moves, rank, total_cars, &tr);
 
-        if (rank == 0) {
-            double v = (total_cars > 0) ? (double)global_moves / (double)total_cars : 0.0;
-            printf("%d\t%.6f\n", t, v);
+            int *tmp   = local_road;
+            local_road = new_local;
+            new_local  = tmp;
         }
-
-        int *tmp   = local_road;
-        local_road = new_local;
-        new_local  = tmp;
     }
-
+    // Primero el lote más viejo (el de cur), luego el último
+    batch_finish(&batch[cur], rank, total_cars, &tr);
+    batch_finish(&batch[cur ^ 1], rank, total_cars, &tr);
     double t1 = MPI_Wtime();
     double elapsed = t1 - t0;
 
+    for (int k = 0; k < 4; ++k) MPI_Request_free(&halo[k]);
+    free(batch_mem);
+    free(halo_mem);
+    if (ca_trace_close(&tr) != 0) {
+        fprintf(stderr, "Error al escribir la traza de velocidad.\n");
+    }
+
     if (rank == 0) {
         fprintf(stderr, "Tiempo total de simulacion (MPI, %d procesos): %.6f s\n",
                 size, elapsed);
 
         // ==== CSV de resultados de tiempo ====
-        // Formato: version,np,N,T,rho,tiempo_total
-        const char *csv_name = "resultados_mpi.csv";
+        // Formato: version,np,N,T,rho,tiempo_total  (version = mpi | mpi_halo<k>)
+        // HPC_CA_CSV=<archivo> cambia el destino (run_halo.sh: resultados_halo.csv)
+        const char *csv_name = getenv("HPC_CA_CSV");
+        if (!csv_name || !*csv_name) csv_name = "resultados_mpi.csv";
         int exists = (access(csv_name, F_OK) == 0);
 
         FILE *f = fopen(csv_name, "a");
@@ -235,14 +350,15 @@ int main(int argc, char **argv) {
             if (!exists) {
                 fprintf(f, "version,np,N,T,rho,tiempo_total\n");
             }
-            fprintf(f, "mpi,%d,%d,%d,%.3f,%.6f\n",
-                    size, N, T, rho, elapsed);
+            char version[32] = "mpi";
+            if (depth > 1) snprintf(version, sizeof version, "mpi_halo%d", depth);
+            fprintf(f, "%s,%d,%d,%d,%.3f,%.6f\n",
+                    version, size, N, T, rho, elapsed);
             fclose(f);
         }
     }
 
-    free(local_road);
-    free(new_local);
+    arena_destroy(&ar);
 
     MPI_Finalize();
     return 0;
@@ -1,8 +1,18 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <sys/time.h>
+#include <stdint.h>
+#include <limits.h>
 #include <unistd.h>  // para access()
+#include "../common/arena.h"
+#include "../common/ca_bits.h"
+#include "../common/ca_trace.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /**
  * Inicializa la carretera con carros (1) y huecos (0)
@@ -26,6 +36,47 @@ int count_cars(const int *road, int N) {
     return total;
 }
 
+/**
+ * Nuevo estado de la celda i (regla 184) con sus vecinos L = i-1 y R = i+1:
+ * si hay carro se queda solo si está bloqueado (R), si no llega el de atrás (L).
+ * Suma a *moves 1 si el carro de i avanza.
+ */
+static inline int cell_184(int L, int C, int R, int *moves) {
+    *moves += C & (R ^ 1);
+    return C ? R : L;
+}
+
+/**
+ * Actualiza las celdas [lo, hi) en una sola pasada: cada celda de new_road se
+ * escribe exactamente una vez y los movimientos se cuentan en el mismo bucle.
+ * Las celdas 0 y N-1 (vecinos periódicos) se tratan fuera del bucle interior,
+ * que queda sin saltos y lo vectoriza el compilador.
+ * Devuelve el número de carros de [lo, hi) que avanzaron.
+ */
+int step_range(const int *road, int *new_road, int N, int lo, int hi) {
+    int moves = 0;
+    if (lo >= hi) return 0;
+    if (N == 1) {
+        new_road[0] = cell_184(road[0], road[0], road[0], &moves);
+        return moves;
+    }
+    int a = lo, b = hi;
+    if (a == 0) {
+        new_road[0] = cell_184(road[N - 1], road[0], road[1], &moves);
+        a = 1;
+    }
+    if (b == N && b > a) {
+        new_road[N - 1] = cell_184(road[N - 2], road[N - 1], road[0], &moves);
+        b = N - 1;
+    }
+    for (int i = a; i < b; ++i) {
+        int C = road[i], R = road[i + 1];
+        moves += C & (R ^ 1);
+        new_road[i] = C ? R : road[i - 1];
+    }
+    return moves;
+}
+
 /**
  * Realiza un paso de tiempo del autómata.
  * road      = estado actual
@@ -34,30 +85,58 @@ int count_cars(const int *road, int N) {
  * moves_out = número de carros que se movieron en este paso
  */
 void step(const int *road, int *new_road, int N, int *moves_out) {
-    int moves = 0;
+    *moves_out = step_range(road, new_road, N, 0, N);
+}
 
-    // Inicializamos el nuevo estado a 0 (todas vacías)
-    for (int i = 0; i < N; ++i) {
-        new_road[i] = 0;
-    }
+#ifdef _OPENMP
+/**
+ * Motor OpenMP (HPC_CA_ENGINE=omp, hilos con OMP_NUM_THREADS): UNA región
+ * paralela para las T iteraciones. Cada hilo se queda con el mismo tramo
+ * [lo, hi) (alineado a 16 celdas = 64B: sin compartir líneas al escribir) y
+ * lleva sus propios punteros de doble buffer. Una sola barrera por paso:
+ * tras ella el paso t está completo, el hilo 0 suma los contadores y guarda v
+ * mientras los demás ya calculan t+1. Los contadores van en dos ranuras
+ * (t & 1) para que t+1 no pise lo que el hilo 0 aún está sumando.
+ */
+typedef struct {
+    _Alignas(64) int moves[2];
+} moves_slot_t;
 
-    // Recorremos celdas de la carretera
-    for (int i = 0; i < N; ++i) {
-        if (road[i] == 1) {
-            int j = (i + 1 == N) ? 0 : (i + 1);  // celda de adelante (periódico)
-            if (road[j] == 0) {
-                // La celda de adelante está vacía: el carro avanza
-                new_road[j] = 1;
-                moves++;
-            } else {
-                // La celda de adelante está ocupada: el carro se queda
-                new_road[i] = 1;
+static inline int split_16(int N, int parts, int k) {
+    if (k >= parts) return N;
+    return (int)((long long)N * k / parts) & ~15;
+}
+
+int run_omp(int *road, int *new_road, int N, int T, long long total_cars, ca_trace_t *tr) {
+    int P = omp_get_max_threads();
+    moves_slot_t *slot = (moves_slot_t*)aligned_alloc(64, (size_t)P * sizeof *slot);
+    if (!slot) return -1;
+
+    #pragma omp parallel num_threads(P)
+    {
+        int id = omp_get_thread_num(), nt = omp_get_num_threads();
+        int lo = split_16(N, nt, id), hi = split_16(N, nt, id + 1);
+        int *cur = road, *nxt = new_road;
+
+        for (int t = 0; t < T; ++t) {
+            slot[id].moves[t & 1] = step_range(cur, nxt, N, lo, hi);
+            #pragma omp barrier
+            if (id == 0) {
+                long long moves = 0;
+                for (int k = 0; k < nt; ++k) moves += slot[k].moves[t & 1];
+                double v = (total_cars > 0) ? (double)moves / (double)total_cars : 0.0;
+                ca_trace_push(tr, t, v);
             }
+            int *tmp = cur;
+            cur = nxt;
+            nxt = tmp;
         }
     }
 
-    *moves_out = moves;
+    free(slot);
+    return 0;
 }
+#endif
 
 /**
  * Tiempo en segundos usando gettimeofday (portátil).
@@ -69,19 +148,30 @@ double get_time_sec(void) {
 }
 
 int main(int argc, char **argv) {
-    int N = 100000;      // número de celdas de la carretera
+    long long N = 100000;  // número de celdas de la carretera
     int T = 1000;        // número de iteraciones
     double rho = 0.3;    // densidad de carros (0..1)
     unsigned int seed = (unsigned int)time(NULL);
+    // HPC_CA_ENGINE=bits: 64 celdas por palabra (ca_bits.h), permite N > 2^31
+    // HPC_CA_ENGINE=omp:  un int por celda con hilos (compilar con -fopenmp)
+    int bits = ca_bits_enabled();
+    const char *engine = getenv("HPC_CA_ENGINE");
+    int omp = engine && strcmp(engine, "omp") == 0;
+#ifndef _OPENMP
+    if (omp) {
+        fprintf(stderr, "Aviso: compilado sin -fopenmp, HPC_CA_ENGINE=omp corre en serie.\n");
+        omp = 0;
+    }
+#endif
 
-    if (argc > 1) N   = atoi(argv[1]);
+    if (argc > 1) N   = atoll(argv[1]);
     if (argc > 2) T   = atoi(argv[2]);
     if (argc > 3) rho = atof(argv[3]);
     if (argc > 4) seed = (unsigned int)atoi(argv[4]);
 
-    if (N <= 0 || T <= 0 || rho < 0.0 || rho > 1.0) {
+    if (N <= 0 || (!bits && N > INT_MAX) || T <= 0 || rho < 0.0 || rho > 1.0) {
         fprintf(stderr, "Uso: %s [N] [T] [rho] [seed]\n", argv[0]);
-        fprintf(stderr, "  N    = tamaño de la carretera (entero > 0)\n");
+        fprintf(stderr, "  N    = tamaño de la carretera (entero > 0; > 2^31 solo con HPC_CA_ENGINE=bits)\n");
         fprintf(stderr, "  T    = iteraciones de tiempo (entero > 0)\n");
         fprintf(stderr, "  rho  = densidad inicial de carros (0.0 .. 1.0)\n");
         fprintf(stderr, "  seed = semilla del RNG (opcional)\n");
@@ -90,52 +180,91 @@ int main(int argc, char **argv) {
 
     srand(seed);
 
-    int *road     = (int*)malloc(N * sizeof(int));
-    int *new_road = (int*)malloc(N * sizeof(int));
-
-    if (!road || !new_road) {
+    // Ambos buffers en una sola arena con huge pages (HPC_HUGEPAGES=0 para 4KB)
+    size_t bytes = bits ? ca_bits_words((uint64_t)N) * sizeof(uint64_t) : (size_t)N * sizeof(int);
+    arena_t ar;
+    if (!arena_init(&ar, 2 * arena_round_up(bytes, ARENA_ALIGN), 0)) {
         fprintf(stderr, "Error: no se pudo reservar memoria.\n");
-        free(road);
-        free(new_road);
         return EXIT_FAILURE;
     }
+    arena_prefault(&ar, (int)sysconf(_SC_NPROCESSORS_ONLN));
 
-    // Inicializamos la carretera
-    init_road(road, N, rho);
+    void *road     = arena_alloc(&ar, bytes);
+    void *new_road = arena_alloc(&ar, bytes);
 
-    // Contamos carros una vez (se conserva en el tiempo)
-    int total_cars = count_cars(road, N);
+    // Inicializamos la carretera (misma secuencia de rand() en los dos motores)
+    long long total_cars;
+    if (bits) {
+        ca_bits_init_rand(road, (uint64_t)N, rho);
+        total_cars = (long long)ca_bits_count(road, ca_bits_words((uint64_t)N));
+    } else {
+        init_road(road, (int)N, rho);
+        // Contamos carros una vez (se conserva en el tiempo)
+        total_cars = count_cars(road, (int)N);
+    }
     if (total_cars == 0) {
         fprintf(stderr, "Advertencia: no hay carros en la carretera (rho muy baja?).\n");
     }
 
-    printf("# N = %d, T = %d, rho = %.3f, carros = %d\n", N, T, rho, total_cars);
+    printf("# N = %lld, T = %d, rho = %.3f, carros = %lld\n", N, T, rho, total_cars);
     printf("# t\tvelocidad\n");
 
+    // Traza de velocidad (ca_trace.h): el bucle solo guarda v; el texto se
+    // escribe al cerrar, fuera de la medición
+    ca_trace_t tr;
+    if (ca_trace_open(&tr) != 0) {
+        fprintf(stderr, "Error: no se pudo abrir la traza de velocidad.\n");
+        return EXIT_FAILURE;
+    }
+
     double t0 = get_time_sec();
 
+#ifdef _OPENMP
+    if (omp && run_omp(road, new_road, (int)N, T, total_cars, &tr) != 0) {
+        fprintf(stderr, "Error: no se pudo reservar memoria.\n");
+        return EXIT_FAILURE;
+    }
+#endif
+
     // Bucle temporal principal
-    for (int t = 0; t < T; ++t) {
-        int moves;
-        step(road, new_road, N, &moves);
+    for (int t = 0; t < T && !omp; ++t) {
+        long long moves;
+        if (bits) {
+            moves = (long long)ca_bits_step_periodic(road, new_road, (uint64_t)N);
+        } else {
+            int m;
+            step(road, new_road, (int)N, &m);
+            moves = m;
+        }
 
         // Intercambiamos punteros (doble buffer)
-        int *tmp = road;
+        void *tmp = road;
         road = new_road;
         new_road = tmp;
 
         double v = (total_cars > 0) ? (double)moves / (double)total_cars : 0.0;
 
-        // Imprimir velocidad por iteración (para luego graficar si quieres)
-        printf("%d\t%.6f\n", t, v);
+        // Velocidad por iteración (para luego graficar si quieres)
+        ca_trace_push(&tr, t, v);
     }
 
     double t1 = get_time_sec();
+    if (ca_trace_close(&tr) != 0) {
+        fprintf(stderr, "Error al escribir la traza de velocidad.\n");
+    }
     double elapsed = t1 - t0;
-    fprintf(stderr, "Tiempo total de simulacion (serial): %.6f s\n", elapsed);
+    const char *version = bits ? "serial_bits" : "serial";
+    int np = 1;
+#ifdef _OPENMP
+    if (omp) {
+        version = "omp";
+        np = omp_get_max_threads();
+    }
+#endif
+    fprintf(stderr, "Tiempo total de simulacion (%s): %.6f s\n", version, elapsed);
 
     // ==== CSV de resultados de tiempo ====
-    // Formato: version,np,N,T,rho,tiempo_total
+    // Formato: version,np,N,T,rho,tiempo_total  (version = serial | serial_bits | omp)
     const char *csv_name = "resultados_serial.csv";
     int exists = (access(csv_name, F_OK) == 0);
 
@@ -146,12 +275,11 @@ int main(int argc, char **argv) {
         if (!exists) {
             fprintf(f, "version,np,N,T,rho,tiempo_total\n");
         }
-        fprintf(f, "serial,1,%d,%d,%.3f,%.6f\n", N, T, rho, elapsed);
+        fprintf(f, "%s,%d,%lld,%d,%.3f,%.6f\n", version, np, N, T, rho, elapsed);
         fclose(f);
     }
 
-    free(road);
-    free(new_road);
+    arena_destroy(&ar);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/**
+ * Convierte la traza binaria de velocidad (HPC_CA_TRACE=bin, ver
+ * common/ca_trace.h) al texto que imprimían ca_serial / ca_mpi:
+ *   # t\tvelocidad
+ *   <t>\t<v>
+ * Compilar: gcc -O2 -std=c11 -Wall ca_trace_txt.c -o ca_trace_txt
+ * Uso:      ./ca_trace_txt velocidad.bin > velocidad.txt
+ */
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s traza.bin\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        fprintf(stderr, "No se pudo abrir %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    char magic[4];
+    uint32_t every;
+    uint64_t n;
+    if (fread(magic, 1, 4, f) != 4 || memcmp(magic, "CAVT", 4) != 0 ||
+        fread(&every, sizeof every, 1, f) != 1 || fread(&n, sizeof n, 1, f) != 1 ||
+        every == 0) {
+        fprintf(stderr, "%s no es una traza de velocidad\n", argv[1]);
+        fclose(f);
+        return EXIT_FAILURE;
+    }
+
+    printf("# t\tvelocidad\n");
+    float buf[4096];
+    uint64_t i = 0;
+    while (i < n) {
+        size_t want = (n - i < 4096) ? (size_t)(n - i) : 4096;
+        size_t got = fread(buf, sizeof(float), want, f);
+        for (size_t k = 0; k < got; ++k, ++i) {
+            printf("%llu\t%.6f\n", (unsigned long long)(i * every), buf[k]);
+        }
+        if (got < want) {
+            fprintf(stderr, "Traza truncada: %llu de %llu valores\n",
+                    (unsigned long long)i, (unsigned long long)n);
+            fclose(f);
+            return EXIT_FAILURE;
+        }
+    }
+
+    fclose(f);
+    return EXIT_SUCCESS;
+}
@@ -21,6 +21,9 @@ REPS=10
 # Semilla base para que las ejecuciones sean reproducibles
 SEED_BASE=1234
 
+# La traza de velocidad va a /dev/null: sin traza (HPC_CA_TRACE, ver common/ca_trace.h)
+export HPC_CA_TRACE="${HPC_CA_TRACE:-off}"
+
 # -------------------------------
 # Preparar CSVs
 # -------------------------------
@@ -0,0 +1,90 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# -------------------------------
+# Barrido de profundidad de halo (HPC_CA_HALO) en ca_mpi
+# -------------------------------
+# Con halo k cada rank intercambia k fantasmas y avanza k pasos sin
+# comunicar: k veces menos mensajes a cambio de ~k^2 celdas recalculadas.
+# Al final se imprime, por cada (N, np), la k con menor tiempo mediano.
+
+# Tamaños de la carretera a probar
+NS=(100000 1000000)
+# Iteraciones de tiempo
+TS=(2000)
+# Densidad de carros
+RHO=0.5
+# Número de procesos MPI a probar
+PROCS=(2 4 8)
+# Profundidades de halo
+HALOS=(1 2 4 8 16 32 64)
+# Repeticiones por configuración
+REPS=5
+
+SEED_BASE=1234
+
+# La traza de velocidad va a /dev/null: sin traza (HPC_CA_TRACE, ver common/ca_trace.h)
+export HPC_CA_TRACE="${HPC_CA_TRACE:-off}"
+
+# ca_mpi escribe directamente aquí (HPC_CA_CSV): resultados_mpi.csv de run.sh no se toca
+MPI_CSV="resultados_halo.csv"
+export HPC_CA_CSV="$MPI_CSV"
+
+echo "Limpiando CSV anterior..."
+rm -f "$MPI_CSV"
+
+if [[ ! -x ./ca_mpi ]]; then
+  echo "Error: ./ca_mpi no existe o no es ejecutable. Compila primero:"
+  echo "  mpicc -O2 -std=c11 -Wall ca_mpi.c -o ca_mpi"
+  exit 1
+fi
+
+# -------------------------------
+# Bucle principal de experimentos
+# -------------------------------
+
+for N in "${NS[@]}"; do
+  for T in "${TS[@]}"; do
+    for np in "${PROCS[@]}"; do
+      for k in "${HALOS[@]}"; do
+        # k no puede pasar de las celdas por proceso
+        if (( k > N / np )); then continue; fi
+        for rep in $(seq 1 "$REPS"); do
+          seed=$((SEED_BASE + rep))
+          echo "[HALO] k=$k  np=$np  rep=$rep  N=$N  T=$T  seed=$seed"
+          HPC_CA_HALO="$k" mpirun -np "$np" ./ca_mpi "$N" "$T" "$RHO" "$seed" > /dev/null
+        done
+      done
+    done
+  done
+done
+
+# -------------------------------
+# Mejor k por (N, np): mediana de las repeticiones
+# -------------------------------
+
+echo "=============================================="
+echo "Mejor profundidad de halo por (N, np)"
+echo "=============================================="
+tail -n +2 "$MPI_CSV" \
+  | awk -F, '{ k = $1; sub(/^mpi(_halo)?/, "", k); if (k == "") k = 1;
+               print $3, $2, $4, k, $6 }' \
+  | sort -k1,1n -k2,2n -k3,3n -k4,4n -k5,5g \
+  | awk '{ key = $1 " " $2 " " $3 " " $4; t[key, ++n[key]] = $5; keys[key] = 1 }
+         END {
+           for (key in keys) {
+             m = n[key]; med = (m % 2) ? t[key, (m + 1) / 2] : (t[key, m / 2] + t[key, m / 2 + 1]) / 2;
+             split(key, f, " "); cfg = f[1] " " f[2] " " f[3];
+             if (!(cfg in best) || med < best[cfg]) { best[cfg] = med; bestk[cfg] = f[4] }
+             if (f[4] == 1) base[cfg] = med
+           }
+           printf "%-10s %-4s %-6s %-5s %-10s %s\n", "N", "np", "T", "k", "tiempo", "vs_k1";
+           for (cfg in best) {
+             split(cfg, f, " ");
+             printf "%-10s %-4s %-6s %-5s %-10.6f %.2fx\n", f[1], f[2], f[3], bestk[cfg], best[cfg],
+                    (cfg in base) ? base[cfg] / best[cfg] : 0
+           }
+         }' \
+  | sort -k1,1n -k2,2n
+
+echo "Resultados completos en: $MPI_CSV"
@@ -13,10 +13,16 @@ TS=(2000)              # puedes agregar más: (1000 2000)
 RHOS=(0.3 0.7)             # por ejemplo: (0.1 0.3 0.5 0.7)
 # Repeticiones por configuración (para promediar luego)
 REPS=10
+# Motores de ca_serial (HPC_CA_ENGINE): int = un int por celda, bits = 64 celdas por palabra,
+# omp = int con hilos (OMP_NUM_THREADS; compilar con -fopenmp)
+ENGINES=(int)              # por ejemplo: (int bits)
 
 # Semilla base para que las ejecuciones sean reproducibles
 SEED_BASE=1234
 
+# La traza de velocidad va a /dev/null: sin traza (HPC_CA_TRACE, ver common/ca_trace.h)
+export HPC_CA_TRACE="${HPC_CA_TRACE:-off}"
+
 # -------------------------------
 # Preparar CSVs
 # -------------------------------
@@ -35,7 +41,7 @@ rm -f "$SERIAL_CSV"
 
 if [[ ! -x ./ca_serial ]]; then
   echo "Error: ./ca_serial no existe o no es ejecutable. Compila primero:"
-  echo "  gcc -O2 -std=c11 -Wall ca_serial.c -o ca_serial"
+  echo "  gcc -O2 -std=c11 -Wall -fopenmp ca_serial.c -o ca_serial"
   exit 1
 fi
 
@@ -51,10 +57,12 @@ for N in "${NS[@]}"; do
       echo "Configuración: N=$N, T=$T, rho=$rho"
       echo "=============================================="
 
-      for rep in $(seq 1 "$REPS"); do
-        seed=$((SEED_BASE + rep))
-        echo "[SERIAL] rep=$rep  N=$N  T=$T  rho=$rho  seed=$seed"
-        ./ca_serial "$N" "$T" "$rho" "$seed" > /dev/null
+      for engine in "${ENGINES[@]}"; do
+        for rep in $(seq 1 "$REPS"); do
+          seed=$((SEED_BASE + rep))
+          echo "[SERIAL $engine] rep=$rep  N=$N  T=$T  rho=$rho  seed=$seed"
+          HPC_CA_ENGINE="$engine" ./ca_serial "$N" "$T" "$rho" "$seed" > /dev/null
+        done
       done
 
     done
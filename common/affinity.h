@@ -0,0 +1,240 @@
+// affinity.h — fijar hilos/procesos a CPUs según la topología de sysfs
+//
+// La política se elige con la variable de entorno HPC_AFFINITY:
+//   compact        llena primero los hilos SMT de cada núcleo (0,1 = mismo núcleo)
+//   scatter        reparte entre sockets y núcleos; los hermanos SMT van al final
+//   cores          un trabajador por núcleo físico (nunca dos en el mismo núcleo)
+//   list:0,2,4-7   lista explícita (se recorre cíclicamente si T > len)
+// Sin HPC_AFFINITY (o "none") no se fija nada: comportamiento de siempre.
+//
+// Uso (pthreads/OpenMP: cada hilo se fija a sí mismo; fork: el hijo tras fork()):
+//   affinity_t aff;
+//   affinity_from_env(&aff, T);
+//   ... en el trabajador i:  affinity_pin_thread(&aff, i);   // o affinity_pin_process
+//   ... al escribir la salida: affinity_format(&aff, buf, sizeof buf, ',');
+//   ... al destruir el pool/equipo: affinity_release(&aff);
+//
+// Si el kernel rechaza una fijación (p. ej. una CPU fuera del cpuset del
+// cgroup) affinity_pin_* devuelve el error y lo cuenta en aff.failed, que está
+// en memoria compartida (vale para hilos y para hijos de fork()); entonces
+// affinity_format escribe "<política>:failed" en vez del mapeo pedido.
+//
+// Requiere _GNU_SOURCE antes de cualquier #include (cpu_set_t, pthread_setaffinity_np).
+
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define AFF_MAX_CPUS 1024
+
+typedef struct {
+    int cpu, core, pkg, smt;   // smt = posición dentro de thread_siblings_list
+    int rank;                  // núcleo dentro de su socket (ver aff_core_rank)
+} aff_cpu_t;
+
+typedef struct {
+    int enabled;               // 0: no se fija afinidad
+    char policy[16];
+    int n;                     // largo de la lista de CPUs (orden de asignación)
+    int cpus[AFF_MAX_CPUS];    // el trabajador i va a cpus[i % n]
+    int T;                     // trabajadores pedidos (para el reporte)
+    int *failed;               // fijaciones rechazadas (MAP_SHARED: cuenta también fork())
+} affinity_t;
+
+// ---- lectura de sysfs ----
+static inline int aff_read_int(const char *path, int def) {
+    FILE *f = fopen(path, "r");
+    if (!f) return def;
+    int v = def;
+    if (fscanf(f, "%d", &v) != 1) v = def;
+    fclose(f);
+    return v;
+}
+
+// Parsea "0-3,8,10-11" en out[]; devuelve cuántos leyó
+static inline int aff_parse_list(const char *s, int *out, int max) {
+    int n = 0;
+    while (*s && n < max) {
+        char *end;
+        long a = strtol(s, &end, 10);
+        if (end == s) break;
+        long b = a;
+        if (*end == '-') { s = end + 1; b = strtol(s, &end, 10); }
+        for (long c = a; c <= b && n < max; ++c) out[n++] = (int)c;
+        s = end;
+        if (*s == ',') s++;
+        else break;
+    }
+    return n;
+}
+
+// CPUs en línea con su núcleo/socket/posición SMT. Devuelve cuántas.
+static inline int aff_topology(aff_cpu_t *t, int max) {
+    int ids[AFF_MAX_CPUS];
+    int n = 0;
+    FILE *f = fopen("/sys/devices/system/cpu/online", "r");
+    if (f) {
+        char buf[4096];
+        if (fgets(buf, sizeof buf, f)) n = aff_parse_list(buf, ids, AFF_MAX_CPUS);
+        fclose(f);
+    }
+    if (n == 0) { ids[0] = 0; n = 1; }
+    if (n > max) n = max;
+
+    char path[128];
+    for (int i = 0; i < n; ++i) {
+        int c = ids[i];
+        t[i].cpu = c;
+        snprintf(path, sizeof path, "/sys/devices/system/cpu/cpu%d/topology/core_id", c);
+        t[i].core = aff_read_int(path, c);
+        snprintf(path, sizeof path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c);
+        t[i].pkg = aff_read_int(path, 0);
+
+        // smt: índice de c dentro de sus hermanos (0 = primer hilo del núcleo)
+        t[i].smt = 0;
+        snprintf(path, sizeof path, "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", c);
+        FILE *g = fopen(path, "r");
+        if (g) {
+            char buf[256];
+            int sib[64];
+            if (fgets(buf, sizeof buf, g)) {
+                int m = aff_parse_list(buf, sib, 64);
+                for (int k = 0; k < m; ++k) if (sib[k] == c) t[i].smt = k;
+            }
+            fclose(g);
+        }
+    }
+    return n;
+}
+
+// ---- órdenes de asignación ----
+static inline int aff_cmp_compact(const void *x, const void *y) {
+    const aff_cpu_t *a = x, *b = y;
+    if (a->pkg  != b->pkg)  return a->pkg  - b->pkg;
+    if (a->core != b->core) return a->core - b->core;
+    return a->smt - b->smt;
+}
+
+// rank = posición del núcleo dentro de su socket (los hermanos SMT comparten rank)
+static inline void aff_core_rank(aff_cpu_t *t, int n) {
+    for (int i = 0; i < n; ++i) {
+        int r = 0;
+        for (int j = 0; j < n; ++j)
+            if (t[j].pkg == t[i].pkg && t[j].smt == 0 && t[j].core < t[i].core) r++;
+        t[i].rank = r;
+    }
+}
+
+// scatter: (smt, rank, socket) -> s0c0, s1c0, s0c1, s1c1, ... y al final los hermanos SMT
+static inline int aff_cmp_scatter(const void *x, const void *y) {
+    const aff_cpu_t *a = x, *b = y;
+    if (a->smt  != b->smt)  return a->smt  - b->smt;
+    if (a->rank != b->rank) return a->rank - b->rank;
+    return a->pkg - b->pkg;
+}
+
+// Contador de fallos compartido; una página por affinity_from_env activo
+static inline int aff_enable(affinity_t *a) {
+    void *p = mmap(NULL, sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "HPC_AFFINITY: sin memoria para el contador de fallos\n");
+        return 0;
+    }
+    a->failed = (int*)p;
+    a->enabled = 1;
+    return 1;
+}
+
+// Construye la lista de CPUs. Devuelve 1 si hay política activa, 0 si no.
+static inline int affinity_from_env(affinity_t *a, int T) {
+    memset(a, 0, sizeof(*a));
+    a->T = T;
+    const char *env = getenv("HPC_AFFINITY");
+    if (!env || !*env || strcmp(env, "none") == 0) return 0;
+
+    if (strncmp(env, "list:", 5) == 0) {
+        a->n = aff_parse_list(env + 5, a->cpus, AFF_MAX_CPUS);
+        if (a->n == 0) { fprintf(stderr, "HPC_AFFINITY: lista vacía (%s)\n", env); return 0; }
+        snprintf(a->policy, sizeof a->policy, "list");
+        return aff_enable(a);
+    }
+
+    static aff_cpu_t t[AFF_MAX_CPUS];
+    int n = aff_topology(t, AFF_MAX_CPUS);
+    qsort(t, (size_t)n, sizeof(*t), aff_cmp_compact);
+
+    if (strcmp(env, "compact") == 0) {
+        for (int i = 0; i < n; ++i) a->cpus[a->n++] = t[i].cpu;
+    } else if (strcmp(env, "scatter") == 0 || strcmp(env, "cores") == 0) {
+        // cores = scatter restringido al primer hilo SMT de cada núcleo
+        int only_first = (strcmp(env, "cores") == 0);
+        aff_core_rank(t, n);
+        qsort(t, (size_t)n, sizeof(*t), aff_cmp_scatter);
+        for (int i = 0; i < n; ++i)
+            if (!only_first || t[i].smt == 0) a->cpus[a->n++] = t[i].cpu;
+        if (only_first && T > a->n)
+            fprintf(stderr, "HPC_AFFINITY=cores: %d trabajadores para %d núcleos físicos (se comparten)\n",
+                    T, a->n);
+    } else {
+        fprintf(stderr, "HPC_AFFINITY desconocida: %s (compact|scatter|cores|list:...)\n", env);
+        return 0;
+    }
+    if (a->n == 0) return 0;
+    snprintf(a->policy, sizeof a->policy, "%s", env);
+    return aff_enable(a);
+}
+
+// Devuelve la página del contador; a queda sin política (idempotente)
+static inline void affinity_release(affinity_t *a) {
+    if (a->failed) munmap(a->failed, sizeof(int));
+    a->failed = NULL;
+    a->enabled = 0;
+}
+
+static inline int affinity_cpu_of(const affinity_t *a, int i) {
+    return a->cpus[i % a->n];
+}
+
+// Fijaciones rechazadas desde affinity_from_env (0 sin política)
+static inline int affinity_failures(const affinity_t *a) {
+    return a->enabled ? __atomic_load_n(a->failed, __ATOMIC_RELAXED) : 0;
+}
+
+// 0 bien; si no, el código de error (también queda contado en a->failed)
+static inline int affinity_pin_thread(const affinity_t *a, int i) {
+    if (!a->enabled) return 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(affinity_cpu_of(a, i), &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+    if (err) __atomic_fetch_add(a->failed, 1, __ATOMIC_RELAXED);
+    return err;
+}
+
+static inline int affinity_pin_process(const affinity_t *a, int i) {
+    if (!a->enabled) return 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(affinity_cpu_of(a, i), &set);
+    int err = sched_setaffinity(0, sizeof set, &set) != 0 ? errno : 0;
+    if (err) __atomic_fetch_add(a->failed, 1, __ATOMIC_RELAXED);
+    return err;
+}
+
+// "compact:0,1,2,3" (sep separa las CPUs; usar ';' dentro de un CSV). "none" si no hay
+// política y "compact:failed" si alguna fijación fue rechazada (el mapeo no sería cierto).
+static inline const char* affinity_format(const affinity_t *a, char *buf, size_t len, char sep) {
+    if (!a->enabled) { snprintf(buf, len, "none"); return buf; }
+    if (affinity_failures(a)) { snprintf(buf, len, "%s:failed", a->policy); return buf; }
+    size_t o = (size_t)snprintf(buf, len, "%s:", a->policy);
+    for (int i = 0; i < a->T && o + 1 < len; ++i) {
+        if (i) buf[o++] = sep;
+        o += (size_t)snprintf(buf + o, len - o, "%d", affinity_cpu_of(a, i));
+    }
+    return buf;
+}
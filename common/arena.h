@@ -0,0 +1,245 @@
+// arena.h — arena de memoria con páginas grandes (huge pages)
+//
+// Reserva UNA sola región para todas las matrices / buffers del programa y
+// reparte trozos alineados a 64B (bump allocator). Orden de intentos:
+//   1) mmap(MAP_HUGETLB)            -> páginas de 2MB reservadas (hugetlbfs)
+//   2) mmap + madvise(MADV_HUGEPAGE) -> Transparent Huge Pages (THP)
+//   3) mmap normal                  -> páginas de 4KB (fallback silencioso)
+//
+// Variables de entorno:
+//   HPC_HUGEPAGES=0   fuerza páginas de 4KB (para comparar fallos de dTLB)
+//   HPC_TLB=1         los programas añaden "pages=<tipo> dtlb_misses=<n>" a su línea de salida
+//
+// Uso:
+//   arena_t ar;
+//   arena_init(&ar, 3*bytes_matriz, 0);      // o ARENA_SHARED para fork()
+//   arena_prefault(&ar, T);                  // toca las páginas en paralelo
+//   int32_t *A = arena_alloc(&ar, bytes_matriz);
+//   ...
+//   arena_destroy(&ar);
+//
+// Requiere _GNU_SOURCE antes de cualquier #include (MAP_HUGETLB, MADV_HUGEPAGE).
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define ARENA_HUGE_PAGE  (2u << 20)   // 2MB (x86-64)
+#define ARENA_ALIGN      64u
+
+// flags de arena_init
+#define ARENA_SHARED     1            // MAP_SHARED: visible tras fork()
+#define ARENA_NO_HUGE    2            // no intentar huge pages
+
+enum { ARENA_4K = 0, ARENA_THP = 1, ARENA_HUGETLB = 2 };
+
+typedef struct {
+    unsigned char *base;   // inicio de la región (alineado a 2MB si hay huge pages)
+    size_t size;           // bytes mapeados
+    size_t used;           // bytes ya repartidos
+    unsigned char *map;    // mapeo original (puede incluir relleno de alineación)
+    size_t map_size;
+    int kind;              // ARENA_4K | ARENA_THP | ARENA_HUGETLB
+} arena_t;
+
+static inline size_t arena_round_up(size_t x, size_t a) { return (x + a - 1) / a * a; }
+
+static inline const char* arena_kind_name(const arena_t *a) {
+    switch (a->kind) {
+        case ARENA_HUGETLB: return "hugetlb";
+        case ARENA_THP:     return "thp";
+        default:            return "4k";
+    }
+}
+
+// Huge pages deshabilitadas por entorno (HPC_HUGEPAGES=0)
+static inline int arena_huge_disabled_env(void) {
+    const char *s = getenv("HPC_HUGEPAGES");
+    return s && s[0] == '0';
+}
+
+// Devuelve 1 si pudo reservar la región, 0 si no (en ese caso a->base == NULL).
+static inline int arena_init(arena_t *a, size_t bytes, int flags) {
+    memset(a, 0, sizeof(*a));
+    int share = (flags & ARENA_SHARED) ? MAP_SHARED : MAP_PRIVATE;
+    int want_huge = !(flags & ARENA_NO_HUGE) && !arena_huge_disabled_env();
+    size_t size = arena_round_up(bytes ? bytes : 1, ARENA_HUGE_PAGE);
+
+    // 1) hugetlbfs: falla con ENOMEM si el admin no reservó páginas (vm.nr_hugepages)
+    if (want_huge) {
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                       share | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            a->base = a->map = (unsigned char*)p;
+            a->size = a->map_size = size;
+            a->kind = ARENA_HUGETLB;
+            return 1;
+        }
+    }
+
+    // 2/3) mapeo normal; si queremos THP, sobre-reservamos 2MB para alinear
+    size_t map_size = want_huge ? size + ARENA_HUGE_PAGE : size;
+    void *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                   share | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return 0;
+
+    a->map = (unsigned char*)p;
+    a->map_size = map_size;
+    a->base = a->map;
+    a->size = size;
+    a->kind = ARENA_4K;
+
+    if (want_huge) {
+        uintptr_t u = (uintptr_t)p;
+        a->base = (unsigned char*)arena_round_up(u, ARENA_HUGE_PAGE);
+        if (madvise(a->base, a->size, MADV_HUGEPAGE) == 0) a->kind = ARENA_THP;
+    }
+    return 1;
+}
+
+static inline void arena_destroy(arena_t *a) {
+    if (a->map) munmap(a->map, a->map_size);
+    memset(a, 0, sizeof(*a));
+}
+
+// Trozo alineado a 64B; NULL si no cabe.
+static inline void* arena_alloc(arena_t *a, size_t bytes) {
+    size_t off = arena_round_up(a->used, ARENA_ALIGN);
+    if (!a->base || off + bytes > a->size) return NULL;
+    a->used = off + bytes;
+    return a->base + off;
+}
+
+// ---- prefault paralelo: cada hilo escribe un byte por página de 4KB de su tramo ----
+typedef struct { unsigned char *p; size_t len; } arena_touch_t;
+
+static inline void* arena_touch_worker(void *arg) {
+    arena_touch_t *t = (arena_touch_t*)arg;
+    volatile unsigned char *p = t->p;
+    for (size_t off = 0; off < t->len; off += 4096) p[off] = 0;
+    return NULL;
+}
+
+// Toca toda la región con T hilos (la memoria recién mapeada ya es cero,
+// así que esto no cambia el contenido). Los tramos van alineados a 2MB para
+// que cada huge page la falle un solo hilo.
+static inline void arena_prefault(arena_t *a, int T) {
+    if (!a->base) return;
+    if (T < 1) T = 1;
+    size_t pages = a->size / ARENA_HUGE_PAGE;
+    if ((size_t)T > pages) T = (int)pages;
+
+    pthread_t *th = (pthread_t*)malloc((size_t)T * sizeof(*th));
+    arena_touch_t *args = (arena_touch_t*)malloc((size_t)T * sizeof(*args));
+    if (!th || !args) {
+        free(th); free(args);
+        arena_touch_t all = { a->base, a->size };
+        arena_touch_worker(&all);
+        return;
+    }
+
+    size_t per = pages / (size_t)T, rem = pages % (size_t)T, first = 0;
+    for (int i = 0; i < T; ++i) {
+        size_t cnt = per + ((size_t)i < rem ? 1 : 0);
+        args[i].p = a->base + first * ARENA_HUGE_PAGE;
+        args[i].len = cnt * ARENA_HUGE_PAGE;
+        first += cnt;
+        if (pthread_create(&th[i], NULL, arena_touch_worker, &args[i]) != 0) {
+            arena_touch_worker(&args[i]);
+            th[i] = pthread_self();
+        }
+    }
+    for (int i = 0; i < T; ++i)
+        if (!pthread_equal(th[i], pthread_self())) pthread_join(th[i], NULL);
+
+    free(th); free(args);
+}
+
+// kB de la región respaldados de verdad por huge pages (AnonHugePages en smaps).
+// Para ARENA_HUGETLB devuelve el tamaño completo. -1 si no se pudo leer.
+static inline long arena_huge_kb(const arena_t *a) {
+    if (a->kind == ARENA_HUGETLB) return (long)(a->size >> 10);
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (!f) return -1;
+    char line[256];
+    int inside = 0;
+    long total = 0;
+    while (fgets(line, sizeof line, f)) {
+        unsigned long lo, hi;
+        if (sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+            inside = (uintptr_t)lo < (uintptr_t)(a->base + a->size) &&
+                     (uintptr_t)hi > (uintptr_t)a->base;
+            continue;
+        }
+        long kb;
+        if (inside && (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1 ||
+                       sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1))
+            total += kb;
+    }
+    fclose(f);
+    return total;
+}
+
+// ---- contador de fallos de dTLB (perf_event_open) ----
+// Se abre al inicio de main (antes de crear hilos/procesos) con inherit=1 para
+// que cuente también los hilos OpenMP/pthreads y los hijos de fork().
+// Si el kernel/VM no expone la PMU, fd queda en -1 y se reporta "na".
+typedef struct { int fd; } tlb_counter_t;
+
+static inline int tlb_report_enabled(void) {
+    const char *s = getenv("HPC_TLB");
+    return s && s[0] == '1';
+}
+
+static inline void tlb_counter_open(tlb_counter_t *c) {
+    struct perf_event_attr pe;
+    memset(&pe, 0, sizeof pe);
+    pe.size = sizeof pe;
+    pe.type = PERF_TYPE_HW_CACHE;
+    pe.config = PERF_COUNT_HW_CACHE_DTLB |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    pe.disabled = 1;
+    pe.inherit = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    c->fd = (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+}
+
+static inline void tlb_counter_start(tlb_counter_t *c) {
+    if (c->fd < 0) return;
+    ioctl(c->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static inline void tlb_counter_stop(tlb_counter_t *c) {
+    if (c->fd >= 0) ioctl(c->fd, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+// -1 si no hay contador
+static inline long long tlb_counter_read(tlb_counter_t *c) {
+    long long v = 0;
+    if (c->fd < 0 || read(c->fd, &v, sizeof v) != (ssize_t)sizeof v) return -1;
+    return v;
+}
+
+static inline void tlb_counter_close(tlb_counter_t *c) {
+    if (c->fd >= 0) close(c->fd);
+    c->fd = -1;
+}
+
+// Sufijo " pages=<tipo> huge_kb=<kB> dtlb_misses=<n|na>" para la línea de salida
+static inline void arena_report(FILE *f, const arena_t *a, tlb_counter_t *c) {
+    long long m = tlb_counter_read(c);
+    fprintf(f, " pages=%s huge_kb=%ld", arena_kind_name(a), arena_huge_kb(a));
+    if (m >= 0) fprintf(f, " dtlb_misses=%lld", m);
+    else        fprintf(f, " dtlb_misses=na");
+}
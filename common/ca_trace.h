@@ -0,0 +1,138 @@
+// ca_trace.h — salida de la traza de velocidad v(t) del autómata de tráfico
+//
+// Antes cada paso hacía printf("%d\t%.6f\n", t, v) dentro del bucle medido
+// (y run.sh lo mandaba a /dev/null). Aquí el bucle solo guarda un número:
+//
+//   HPC_CA_TRACE=text   (defecto) misma salida de texto por stdout, pero los
+//                       valores se guardan en memoria y se formatean en
+//                       ca_trace_close, fuera de la medición
+//   HPC_CA_TRACE=bin    arreglo binario de float en HPC_CA_TRACE_FILE
+//                       (defecto CA_TRACE_FILE) a través de un búfer de
+//                       CA_TRACE_BUF valores; ca_trace_txt lo pasa a texto
+//   HPC_CA_TRACE=off    nada
+//   HPC_CA_TRACE_EVERY=k  solo los pasos t % k == 0 (defecto 1)
+//
+// Formato binario (little-endian, el de la máquina):
+//   "CAVT"  uint32 every  uint64 n   (16 bytes; n se escribe al cerrar)
+//   float v[n]                        v[i] = velocidad en t = i * every
+//
+// Uso:
+//   ca_trace_t tr;
+//   if (ca_trace_open(&tr) != 0) ...error...
+//   for (t...) ca_trace_push(&tr, t, v);
+//   t1 = ...;                          // medir antes de cerrar
+//   ca_trace_close(&tr);
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CA_TRACE_FILE  "velocidad.bin"
+#define CA_TRACE_BUF   (1u << 20)       // floats por escritura (4 MB)
+#define CA_TRACE_MAGIC "CAVT"
+
+enum { CA_TRACE_OFF = 0, CA_TRACE_TEXT = 1, CA_TRACE_BIN = 2 };
+
+typedef struct {
+    int mode;            // CA_TRACE_*
+    int every;           // guardar un paso de cada `every`
+    FILE *f;             // bin: archivo de salida
+    float *buf;          // bin: búfer de escritura
+    double *vals;        // text: valores pendientes de formatear
+    size_t n, cap;       // ocupados / capacidad de buf o vals
+    int direct;          // text sin memoria para vals: printf en cada push
+    uint64_t total;      // bin: valores ya escritos
+} ca_trace_t;
+
+static inline const char *ca_trace_mode_name(int mode) {
+    return mode == CA_TRACE_OFF ? "off" : mode == CA_TRACE_BIN ? "bin" : "text";
+}
+
+// 0 bien, -1 no se pudo abrir el archivo o reservar el búfer
+static inline int ca_trace_open(ca_trace_t *tr) {
+    memset(tr, 0, sizeof *tr);
+    tr->mode = CA_TRACE_TEXT;
+    tr->every = 1;
+    const char *m = getenv("HPC_CA_TRACE");
+    if (m && !strcmp(m, "off")) tr->mode = CA_TRACE_OFF;
+    else if (m && !strcmp(m, "bin")) tr->mode = CA_TRACE_BIN;
+    const char *k = getenv("HPC_CA_TRACE_EVERY");
+    if (k && atoi(k) > 0) tr->every = atoi(k);
+
+    if (tr->mode == CA_TRACE_BIN) {
+        const char *path = getenv("HPC_CA_TRACE_FILE");
+        if (!path || !*path) path = CA_TRACE_FILE;
+        tr->f = fopen(path, "wb");
+        tr->buf = (float*)malloc(CA_TRACE_BUF * sizeof(float));
+        if (!tr->f || !tr->buf) {
+            if (tr->f) fclose(tr->f);
+            free(tr->buf);
+            return -1;
+        }
+        tr->cap = CA_TRACE_BUF;
+        uint32_t every = (uint32_t)tr->every;
+        uint64_t n = 0;
+        fwrite(CA_TRACE_MAGIC, 1, 4, tr->f);
+        fwrite(&every, sizeof every, 1, tr->f);
+        fwrite(&n, sizeof n, 1, tr->f);
+    }
+    return 0;
+}
+
+static inline void ca_trace_flush_bin(ca_trace_t *tr) {
+    if (tr->n == 0) return;
+    fwrite(tr->buf, sizeof(float), tr->n, tr->f);
+    tr->total += tr->n;
+    tr->n = 0;
+}
+
+static inline void ca_trace_push(ca_trace_t *tr, long long t, double v) {
+    if (tr->mode == CA_TRACE_OFF || t % tr->every != 0) return;
+    if (tr->mode == CA_TRACE_BIN) {
+        tr->buf[tr->n++] = (float)v;
+        if (tr->n == tr->cap) ca_trace_flush_bin(tr);
+        return;
+    }
+    if (tr->n == tr->cap && !tr->direct) {
+        size_t cap = tr->cap ? 2 * tr->cap : 4096;
+        double *p = (double*)realloc(tr->vals, cap * sizeof *p);
+        if (p) {
+            tr->vals = p;
+            tr->cap = cap;
+        } else {    // sin memoria: lo pendiente y lo que sigue se escribe directo
+            for (size_t i = 0; i < tr->n; ++i)
+                printf("%lld\t%.6f\n", (long long)i * tr->every, tr->vals[i]);
+            free(tr->vals);
+            tr->vals = NULL;
+            tr->n = 0;
+            tr->direct = 1;
+        }
+    }
+    if (tr->direct) printf("%lld\t%.6f\n", t, v);
+    else tr->vals[tr->n++] = v;
+}
+
+// Escribe lo pendiente (texto a stdout o el resto del binario) y libera.
+// 0 bien, -1 error de escritura.
+static inline int ca_trace_close(ca_trace_t *tr) {
+    int err = 0;
+    if (tr->mode == CA_TRACE_TEXT) {
+        for (size_t i = 0; i < tr->n; ++i)
+            printf("%lld\t%.6f\n", (long long)i * tr->every, tr->vals[i]);
+        err = fflush(stdout) != 0;
+        free(tr->vals);
+    } else if (tr->mode == CA_TRACE_BIN) {
+        ca_trace_flush_bin(tr);
+        err = ferror(tr->f) != 0;
+        if (fseek(tr->f, 8, SEEK_SET) == 0)
+            err |= fwrite(&tr->total, sizeof tr->total, 1, tr->f) != 1;
+        else
+            err = 1;
+        err |= fclose(tr->f) != 0;
+        free(tr->buf);
+    }
+    memset(tr, 0, sizeof *tr);
+    return err ? -1 : 0;
+}
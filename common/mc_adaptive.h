@@ -0,0 +1,120 @@
+// mc_adaptive.h — Monte Carlo con parada por precisión (error estándar objetivo)
+//
+// En vez de un N fijo, N es el presupuesto máximo y la corrida se detiene en
+// cuanto el error estándar de pi baja del objetivo. Los trabajadores:
+//   1) reclaman lotes de MC_ADAPT_BATCH bloques del flujo reproducible
+//      (rng_stream.h) con un fetch_add atómico: los lotes salen en orden, así
+//      las muestras usadas son siempre un prefijo [0, n) del flujo
+//   2) cuentan el lote con el kernel de siempre (mc_kernels.h)
+//   3) publican sus aciertos con sumas atómicas (sin lock global) y, con los
+//      totales, deciden si ya se llegó al objetivo
+// Los lotes ya reclamados se terminan: el total final es consistente.
+//
+// Estadística binomial: cada muestra es un ensayo de Bernoulli (acierto/cruce),
+// p = aciertos / n; se usa el método delta para pasar a pi:
+//   dardo   pi = 4 p                se = 4 sqrt(p (1-p) / n)
+//   buffon  pi = 2 (L/D) / p        se = pi sqrt((1-p) / (p n))
+// IC 95% = pi ± 1.96 se. No se para antes de MC_ADAPT_MIN_N muestras, para
+// que la aproximación normal sea razonable.
+//
+// Uso:
+//   mc_adapt_t ad;
+//   mc_adapt_init(&ad, N, target, MC_EST_DART, 1.0);
+//   (en cada trabajador)
+//   uint64_t a, b;
+//   while (mc_adapt_claim(&ad, &a, &b))
+//       mc_adapt_publish(&ad, mc_dart_count_stream(seed, a, b, mode), b - a);
+//
+// El objetivo se toma de HPC_MC_TARGET (error estándar de pi, p. ej. 1e-4);
+// sin la variable los programas usan N fijo como siempre.
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "rng_stream.h"
+
+#define MC_ADAPT_BATCH  4u                          // bloques por lote (65536 muestras)
+#define MC_ADAPT_MIN_N  (16u * MC_STREAM_BLOCK)     // muestras mínimas antes de parar
+
+enum { MC_EST_DART = 0, MC_EST_BUFFON = 1 };
+
+typedef struct {
+    _Atomic uint64_t next;      // próximo bloque a reclamar
+    _Atomic uint64_t hits, n;   // totales publicados
+    _Atomic int done;
+    uint64_t N;                 // presupuesto de muestras
+    double target;              // error estándar objetivo de pi
+    int kind;                   // MC_EST_*
+    double ratio;               // L/D (solo buffon)
+} mc_adapt_t;
+
+// Objetivo desde HPC_MC_TARGET; 0 si no está (modo N fijo)
+static inline double mc_target_from_env(void) {
+    const char *e = getenv("HPC_MC_TARGET");
+    if (!e || !*e) return 0.0;
+    double t = strtod(e, NULL);
+    return t > 0.0 ? t : 0.0;
+}
+
+static inline double mc_pi_estimate(int kind, uint64_t hits, uint64_t n, double ratio) {
+    if (!n || !hits) return 0.0;
+    double p = (double)hits / (double)n;
+    return kind == MC_EST_DART ? 4.0 * p : 2.0 * ratio / p;
+}
+
+static inline double mc_pi_stderr(int kind, uint64_t hits, uint64_t n, double ratio) {
+    if (!n || !hits) return INFINITY;
+    double p = (double)hits / (double)n;
+    if (kind == MC_EST_DART) return 4.0 * sqrt(p * (1.0 - p) / (double)n);
+    return mc_pi_estimate(kind, hits, n, ratio) * sqrt((1.0 - p) / (p * (double)n));
+}
+
+static inline void mc_adapt_init(mc_adapt_t *ad, uint64_t N, double target, int kind, double ratio) {
+    atomic_init(&ad->next, 0);
+    atomic_init(&ad->hits, 0);
+    atomic_init(&ad->n, 0);
+    atomic_init(&ad->done, 0);
+    ad->N = N;
+    ad->target = target;
+    ad->kind = kind;
+    ad->ratio = ratio;
+}
+
+// Reclama el siguiente lote [*a,*b). 0 si ya se llegó al objetivo o al presupuesto.
+static inline int mc_adapt_claim(mc_adapt_t *ad, uint64_t *a, uint64_t *b) {
+    if (atomic_load_explicit(&ad->done, memory_order_relaxed)) return 0;
+    uint64_t blk = atomic_fetch_add_explicit(&ad->next, MC_ADAPT_BATCH, memory_order_relaxed);
+    uint64_t lo = blk * MC_STREAM_BLOCK;
+    if (lo >= ad->N) return 0;
+    uint64_t hi = lo + (uint64_t)MC_ADAPT_BATCH * MC_STREAM_BLOCK;
+    *a = lo;
+    *b = hi < ad->N ? hi : ad->N;
+    return 1;
+}
+
+// Publica un lote contado y comprueba el objetivo con los totales
+static inline void mc_adapt_publish(mc_adapt_t *ad, uint64_t hits, uint64_t n) {
+    uint64_t H = atomic_fetch_add_explicit(&ad->hits, hits, memory_order_relaxed) + hits;
+    uint64_t M = atomic_fetch_add_explicit(&ad->n, n, memory_order_relaxed) + n;
+    // H y M pueden venir de publicaciones distintas: solo afecta a cuándo se para
+    if (M >= MC_ADAPT_MIN_N && H <= M &&
+        mc_pi_stderr(ad->kind, H, M, ad->ratio) <= ad->target)
+        atomic_store_explicit(&ad->done, 1, memory_order_relaxed);
+}
+
+// Columnas extra de Reto2 en modo adaptativo: ",target=<t>,se=<se>,ci95=<lo>;<hi>"
+static inline void mc_pi_report(FILE *f, int kind, uint64_t hits, uint64_t n,
+                                double target, double ratio) {
+    double pi = mc_pi_estimate(kind, hits, n, ratio);
+    double se = mc_pi_stderr(kind, hits, n, ratio);
+    fprintf(f, ",target=%g,se=%.3e,ci95=%.9f;%.9f",
+            target, se, pi - 1.96 * se, pi + 1.96 * se);
+}
+
+static inline void mc_adapt_report(FILE *f, const mc_adapt_t *ad) {
+    mc_pi_report(f, ad->kind, atomic_load(&ad->hits), atomic_load(&ad->n),
+                 ad->target, ad->ratio);
+}
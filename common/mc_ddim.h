@@ -0,0 +1,111 @@
+// mc_ddim.h — integración Monte Carlo en d dimensiones (volumen de la d-bola, integrandos)
+//
+// El dardo es el caso d = 2 de la d-bola: con u ~ U[0,1)^d,
+//   P(|u|^2 <= 1) = V_d / 2^d,   V_d = pi^(d/2) / Gamma(d/2 + 1)
+// Dos kernels de volumen sobre mc_engine.h (mismo flujo, mismos conteos):
+//
+//   mc_ball      acumula r2[i] += u_k[i]^2 coordenada a coordenada con DOS
+//                bloques de XR_BLOCK (x y r2, 8 KB en L1) para cualquier d:
+//                el costo es solo RNG + un fma vectorial por coordenada
+//   mc_ball_soa  estructura de arreglos completa u[0..d-1][XR_BLOCK] (motor
+//                _DYN): 4 KB por coordenada, d = 12 ya no cabe en L1 (48 KB);
+//                es el formato que necesita un integrando general; d hasta
+//                MC_ENGINE_MAX_DIM (mc_engine_dim_ok), fuera de rango no cuenta
+//
+// Integrandos sobre [0,1]^d: MC_DEFINE_SUM_ESTIMATOR_DYN con un kernel que
+// recorre u[k][i]; mc_sumsq ((sum_k u_k)^2, exacto d/12 + d^2/4) es el ejemplo
+// y sirve de referencia de error.
+//
+// Ojo con acierto/fallo en d alto: p = V_d / 2^d cae muy rápido (d = 10:
+// 2.5e-3, d = 20: 2.5e-8), el error relativo ~ 1/sqrt(p N) se dispara. Para
+// volúmenes en d alto conviene un integrando suave en vez de un indicador.
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include "mc_engine.h"
+
+#define MC_PI 3.14159265358979323846
+
+typedef struct { int d; } mc_ball_p;
+
+static inline double mc_ball_volume_exact(int d) {
+    return pow(MC_PI, 0.5 * d) / tgamma(0.5 * d + 1.0);
+}
+
+// ---- d-bola por acumulación (dos bloques) ----
+static inline void mc_ball_sub(xr_simd_t *r, size_t lo, size_t hi,
+                               const mc_ball_p *p, mc_acc_t *acc) {
+    if (p->d < 1) return;   // sin coordenadas no hay muestra (acc->n no avanza)
+    _Alignas(64) double x[XR_BLOCK], r2[XR_BLOCK];
+    xr_simd_fill01(r, r2, XR_BLOCK);
+    for (size_t i = 0; i < XR_BLOCK; ++i) r2[i] *= r2[i];
+    for (int k = 1; k < p->d; ++k) {
+        xr_simd_fill01(r, x, XR_BLOCK);
+        for (size_t i = 0; i < XR_BLOCK; ++i) r2[i] += x[i] * x[i];
+    }
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i) c += (r2[i] <= 1.0);
+    acc->hits += c;
+    acc->n    += hi - lo;
+}
+static inline double mc_ball_mean(const mc_acc_t *a)   { return mc_acc_hits_mean(a); }
+static inline double mc_ball_stderr(const mc_acc_t *a) { return mc_acc_hits_stderr(a); }
+MC_ENGINE_COMMON(mc_ball, mc_ball_p)
+
+// ---- d-bola sobre el bloque completo de coordenadas ----
+static inline uint64_t mc_ball_soa_k(const double *const *u, size_t lo, size_t hi,
+                                     const mc_ball_p *p) {
+    _Alignas(64) double r2[XR_BLOCK];
+    for (size_t i = lo; i < hi; ++i) r2[i] = u[0][i] * u[0][i];
+    for (int k = 1; k < p->d; ++k) {
+        const double *x = u[k];
+        for (size_t i = lo; i < hi; ++i) r2[i] += x[i] * x[i];
+    }
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i) c += (r2[i] <= 1.0);
+    return c;
+}
+MC_DEFINE_HITS_ESTIMATOR_DYN(mc_ball_soa, mc_ball_p, mc_ball_soa_k)
+
+// Volumen y su error estándar desde el acumulado de mc_ball / mc_ball_soa
+static inline double mc_ball_volume(int d, const mc_acc_t *a) {
+    return ldexp(mc_acc_hits_mean(a), d);
+}
+
+static inline double mc_ball_volume_stderr(int d, const mc_acc_t *a) {
+    return ldexp(mc_acc_hits_stderr(a), d);
+}
+
+// ---- integrando de ejemplo: f(u) = (sum_k u_k)^2 ----
+typedef struct { int d; } mc_sumsq_p;
+
+static inline double mc_sumsq_exact(int d) {
+    return d / 12.0 + 0.25 * d * d;
+}
+
+static inline void mc_sumsq_k(const double *const *u, size_t lo, size_t hi,
+                              const mc_sumsq_p *p, double *s, double *s2) {
+    _Alignas(64) double t[XR_BLOCK];
+    for (size_t i = lo; i < hi; ++i) t[i] = u[0][i];
+    for (int k = 1; k < p->d; ++k) {
+        const double *x = u[k];
+        for (size_t i = lo; i < hi; ++i) t[i] += x[i];
+    }
+    // 8 acumuladores: la suma en double no se vectoriza sola (orden de FP)
+    double a[8] = {0}, a2[8] = {0};
+    size_t i = lo;
+    for (; i + 8 <= hi; i += 8)
+        for (int l = 0; l < 8; ++l) {
+            double f = t[i + l] * t[i + l];
+            a[l] += f;
+            a2[l] += f * f;
+        }
+    for (; i < hi; ++i) {
+        double f = t[i] * t[i];
+        a[0] += f;
+        a2[0] += f * f;
+    }
+    for (int l = 0; l < 8; ++l) { *s += a[l]; *s2 += a2[l]; }
+}
+MC_DEFINE_SUM_ESTIMATOR_DYN(mc_sumsq, mc_sumsq_p, mc_sumsq_k)
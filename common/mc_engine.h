@@ -0,0 +1,394 @@
+// mc_engine.h — motor genérico de estimadores Monte Carlo (C con kernels en línea)
+//
+// Un estimador nuevo = un kernel por bloque + una línea de macro. El motor pone
+// lo común: bloques de XR_BLOCK muestras, generador SIMD (rng_simd.h), flujo
+// reproducible por índice (rng_stream.h), backends y estadística. El kernel
+// se llama por nombre dentro de la función generada: GCC lo especializa y lo
+// inlinea en compilación, sin llamada indirecta por muestra (ni por bloque).
+//
+// Kernel: recibe DIM arreglos de uniformes en [0,1) (u[d][i], i en [lo,hi))
+// y los parámetros del estimador:
+//
+//   HITS  uint64_t K(const double *const *u, size_t lo, size_t hi, const P *p)
+//         devuelve cuántas muestras cumplen (dardo, Buffon, volúmenes):
+//         conteo entero, idéntico para cualquier reparto
+//   SUM   void K(const double *const *u, size_t lo, size_t hi, const P *p,
+//                double *s, double *s2)
+//         suma f y f^2 (integrales); la suma en double depende del orden,
+//         así el último bit puede variar con el reparto
+//
+//   MC_DEFINE_HITS_ESTIMATOR(NAME, DIM, P, K)
+//   MC_DEFINE_SUM_ESTIMATOR (NAME, DIM, P, K)
+//
+// generan:
+//   NAME_stream(seed, a, b, &p, &acc)   muestras [a,b) del flujo (unidad de
+//                                       reparto para hilos, fork o MPI)
+//   NAME_run(seed, N, &p, &acc)         serial
+//   NAME_run_omp(seed, N, &p, &acc)     OpenMP (solo con -fopenmp); parciales
+//                                       por hilo en líneas de caché propias y
+//                                       suma en orden de hilo
+//   NAME_mean(&acc), NAME_stderr(&acc)  media de la muestra y su error estándar
+//
+// y, solo los HITS (los runtimes de abajo reducen contadores enteros), la
+// función de tramo de los runtimes, sobre NAME_stream:
+//   NAME_range(a, b, acc, &job)         acc[0] += aciertos, acc[1] += muestras
+//                                       de [a,b); job = mc_engine_job_t
+//                                       {seed, &p}. Firma de fk_range_fn y de
+//                                       mc_mpi_range_fn
+//   NAME_range_omp(a, b, acc, &job)     igual, [a,b) repartido entre los hilos
+//                                       OpenMP (un rank de MPI)
+// Backends que se generan si su runtime está incluido ANTES de este archivo:
+//   Reto1/common.h  NAME_run_threads(&pool, seed, N, &p, &acc)
+//                   rt_parallel_reduce sobre el pool de pthreads
+//   Reto1/fork_rt.h fk_pool_init(&pool, P, NAME_range, &job, ...) y luego
+//                   mc_engine_run_fork(&pool, N, &acc)
+//   <mpi.h>         NAME_run_mpi(seed, N, &p, comm, &acc) con mc_mpi_run
+//                   (totales en rank 0); con HPC_MC_TARGET se pasa
+//                   NAME_range_omp a mc_mpi_run_target
+// Todos cuentan el mismo flujo: el conteo es idéntico al de NAME_run.
+//
+// Dimensión en tiempo de ejecución: MC_DEFINE_{HITS,SUM}_ESTIMATOR_DYN(NAME,
+// P, K) usan p->d en vez de DIM; el kernel recibe igual u[0..d-1]. d debe
+// estar en [1, MC_ENGINE_MAX_DIM] (mc_engine_dim_ok): si no, no se cuenta
+// nada. Para un bloque propio (p. ej. acumular sin guardar todas las
+// coordenadas, ver mc_ddim.h) se define NAME_sub(r, lo, hi, p, acc) a mano y
+// luego MC_ENGINE_COMMON(NAME, P), o MC_ENGINE_HITS(NAME, P) si cuenta
+// aciertos (añade media, error, NAME_range y los backends).
+//
+// Con DIM = 2 el motor llena u[0] y luego u[1] igual que mc_kernels.h en
+// double: mc_engine_dart da el mismo conteo que mc_dart_count_stream con
+// MC_DART_DOUBLE, y mc_engine_buffon el de mc_buffon_count_stream con
+// MC_SIN_POLY. mc_engine_dart_mode usa como bloque propio mc_dart_sub (dardo
+// int | double | float de HPC_DART): es el que usan dart_v2_threads,
+// dart_v3_fork, Dart_omp y Dart_mpi, con el mismo conteo que antes.
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "rng_simd.h"
+#include "rng_stream.h"
+#include "mc_kernels.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef MPI_VERSION
+#include "mc_mpi.h"
+#endif
+
+#define MC_ENGINE_MAX_DIM 32
+
+// Dimensión válida para los estimadores _DYN; validar p->d con esto antes de correr
+static inline int mc_engine_dim_ok(int d) { return d >= 1 && d <= MC_ENGINE_MAX_DIM; }
+
+typedef struct {
+    uint64_t n;         // muestras
+    uint64_t hits;      // estimadores HITS
+    double sum, sum2;   // estimadores SUM
+} mc_acc_t;
+
+typedef struct {
+    _Alignas(64) mc_acc_t acc;
+} mc_acc_slot_t;
+
+static inline void mc_acc_add(mc_acc_t *t, const mc_acc_t *x) {
+    t->n += x->n;
+    t->hits += x->hits;
+    t->sum += x->sum;
+    t->sum2 += x->sum2;
+}
+
+// Contexto de NAME_range: semilla del flujo y parámetros del estimador
+typedef struct {
+    uint64_t seed;
+    const void *p;
+} mc_engine_job_t;
+
+// Acumulador de un estimador HITS a partir de los contadores de un runtime
+static inline void mc_acc_from_hits(mc_acc_t *acc, const uint64_t t[2]) {
+    memset(acc, 0, sizeof *acc);
+    acc->hits = t[0];
+    acc->n    = t[1];
+}
+
+static inline double mc_acc_hits_mean(const mc_acc_t *a) {
+    return a->n ? (double)a->hits / (double)a->n : 0.0;
+}
+
+static inline double mc_acc_hits_stderr(const mc_acc_t *a) {
+    double p = mc_acc_hits_mean(a);
+    return a->n ? sqrt(p * (1.0 - p) / (double)a->n) : INFINITY;
+}
+
+static inline double mc_acc_sum_mean(const mc_acc_t *a) {
+    return a->n ? a->sum / (double)a->n : 0.0;
+}
+
+static inline double mc_acc_sum_stderr(const mc_acc_t *a) {
+    if (a->n < 2) return INFINITY;
+    double n = (double)a->n, m = a->sum / n;
+    double var = (a->sum2 - n * m * m) / (n - 1.0);
+    return sqrt((var > 0.0 ? var : 0.0) / n);
+}
+
+// ---- cuerpo común: DIM bloques de uniformes y el bucle del flujo ----
+#define MC_ENGINE_FILL(DIM)                                                   \
+    _Static_assert((DIM) >= 1 && (DIM) <= MC_ENGINE_MAX_DIM, "DIM fuera de rango"); \
+    _Alignas(64) double ub_[DIM][XR_BLOCK];                                   \
+    const double *u[DIM];                                                     \
+    for (int d_ = 0; d_ < (DIM); ++d_) {                                      \
+        xr_simd_fill01(r, ub_[d_], XR_BLOCK);                                 \
+        u[d_] = ub_[d_];                                                      \
+    }
+
+// Estructura de arreglos: u[k] es la coordenada k de las XR_BLOCK muestras;
+// solo se llenan (y se tocan en memoria) las d primeras filas. Con d fuera de
+// [1, MC_ENGINE_MAX_DIM] el bloque no se cuenta (el kernel recorrería u[k] sin
+// llenar): acc->n no avanza y la media sale NaN
+#define MC_ENGINE_FILL_DYN(D)                                                 \
+    if (!mc_engine_dim_ok(D)) return;                                         \
+    _Alignas(64) double ub_[MC_ENGINE_MAX_DIM][XR_BLOCK];                     \
+    const double *u[MC_ENGINE_MAX_DIM];                                       \
+    int dd_ = (D);                                                            \
+    for (int d_ = 0; d_ < dd_; ++d_) {                                        \
+        xr_simd_fill01(r, ub_[d_], XR_BLOCK);                                 \
+        u[d_] = ub_[d_];                                                      \
+    }
+
+#define MC_ENGINE_COMMON(NAME, P)                                             \
+static inline void NAME##_stream(uint64_t seed, uint64_t a, uint64_t b,       \
+                                 const P *p, mc_acc_t *acc) {                 \
+    for (uint64_t blk = a / MC_STREAM_BLOCK; blk * MC_STREAM_BLOCK < b; ++blk) { \
+        xr_simd_t r_;                                                         \
+        xr_simd_seed_block(&r_, seed, blk);                                   \
+        uint64_t base = blk * MC_STREAM_BLOCK;                                \
+        for (uint64_t o = 0; o < MC_STREAM_BLOCK && base + o < b; o += XR_BLOCK) { \
+            uint64_t s0 = base + o, s1 = s0 + XR_BLOCK;                       \
+            size_t lo = a <= s0 ? 0 : (a < s1 ? (size_t)(a - s0) : XR_BLOCK); \
+            size_t hi = b >= s1 ? XR_BLOCK : (size_t)(b - s0);                \
+            NAME##_sub(&r_, lo, hi < lo ? lo : hi, p, acc);                   \
+        }                                                                     \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static inline void NAME##_run(uint64_t seed, uint64_t N, const P *p, mc_acc_t *acc) { \
+    memset(acc, 0, sizeof *acc);                                              \
+    NAME##_stream(seed, 0, N, p, acc);                                        \
+}                                                                             \
+MC_ENGINE_OMP(NAME, P)
+
+#ifdef _OPENMP
+#define MC_ENGINE_OMP(NAME, P)                                                \
+static inline void NAME##_run_omp(uint64_t seed, uint64_t N, const P *p, mc_acc_t *acc) { \
+    int T_ = omp_get_max_threads();                                           \
+    mc_acc_slot_t *part_ = (mc_acc_slot_t*)aligned_alloc(64, (size_t)T_ * sizeof *part_); \
+    memset(acc, 0, sizeof *acc);                                              \
+    if (!part_) { NAME##_stream(seed, 0, N, p, acc); return; }                \
+    memset(part_, 0, (size_t)T_ * sizeof *part_);                             \
+    int used_ = 1;                                                            \
+    _Pragma("omp parallel num_threads(T_)")                                   \
+    {                                                                         \
+        int t_ = omp_get_thread_num(), nt_ = omp_get_num_threads();           \
+        uint64_t a_, b_;                                                      \
+        mc_stream_split(N, (uint64_t)nt_, (uint64_t)t_, &a_, &b_);            \
+        NAME##_stream(seed, a_, b_, p, &part_[t_].acc);                       \
+        if (t_ == 0) used_ = nt_;                                             \
+    }                                                                         \
+    for (int t_ = 0; t_ < used_; ++t_) mc_acc_add(acc, &part_[t_].acc);       \
+    free(part_);                                                              \
+}
+
+// Tramo [a,b) de un rank repartido entre sus hilos (conteo entero: el orden
+// de la suma no importa)
+#define MC_ENGINE_RANGE_OMP(NAME, P)                                          \
+static inline void NAME##_range_omp(uint64_t a, uint64_t b, uint64_t acc[2],  \
+                                    const void *job) {                        \
+    const mc_engine_job_t *j_ = (const mc_engine_job_t*)job;                  \
+    uint64_t h_ = 0, n_ = 0;                                                  \
+    _Pragma("omp parallel reduction(+:h_, n_)")                               \
+    {                                                                         \
+        uint64_t x_, y_;                                                      \
+        mc_stream_split(b - a, (uint64_t)omp_get_num_threads(),               \
+                        (uint64_t)omp_get_thread_num(), &x_, &y_);            \
+        mc_acc_t s_ = {0, 0, 0.0, 0.0};                                       \
+        NAME##_stream(j_->seed, a + x_, a + y_, (const P*)j_->p, &s_);        \
+        h_ += s_.hits;                                                        \
+        n_ += s_.n;                                                           \
+    }                                                                         \
+    acc[0] += h_;                                                             \
+    acc[1] += n_;                                                             \
+}
+#else
+#define MC_ENGINE_OMP(NAME, P)
+#define MC_ENGINE_RANGE_OMP(NAME, P)
+#endif
+
+// ---- backends con contadores enteros (solo HITS) ----
+// Reto1/common.h: pool de pthreads con trozos dinámicos (rt_parallel_reduce)
+#ifdef RT_NACC
+_Static_assert(RT_NACC >= 2, "mc_engine necesita RT_NACC >= 2 (aciertos, muestras)");
+#define MC_ENGINE_THREADS(NAME, P)                                            \
+static inline void NAME##_range_rt(uint64_t a, uint64_t b, uint64_t acc[RT_NACC], void *job) { \
+    NAME##_range(a, b, acc, job);                                             \
+}                                                                             \
+static inline void NAME##_run_threads(rt_pool_t *pool, uint64_t seed, uint64_t N, \
+                                      const P *p, mc_acc_t *acc) {            \
+    mc_engine_job_t job_ = { seed, p };                                       \
+    uint64_t t_[RT_NACC];                                                     \
+    rt_parallel_reduce(pool, N, RT_CHUNK, NAME##_range_rt, &job_, t_);        \
+    mc_acc_from_hits(acc, t_);                                                \
+}
+#else
+#define MC_ENGINE_THREADS(NAME, P)
+#endif
+
+// Reto1/fork_rt.h: el cuerpo se fija en fk_pool_init (NAME_range con un
+// mc_engine_job_t que viva mientras viva el pool); aquí solo la corrida
+#ifdef FK_RT_H
+static inline void mc_engine_run_fork(fk_pool_t *pool, uint64_t N, mc_acc_t *acc) {
+    uint64_t t[RT_NACC];
+    fk_pool_run(pool, N, t);
+    mc_acc_from_hits(acc, t);
+}
+#endif
+
+// MPI (+ OpenMP dentro del rank si hay -fopenmp): mc_mpi_run, totales en rank 0
+#ifdef MPI_VERSION
+#ifdef _OPENMP
+#define MC_ENGINE_RANGE_MPI(NAME) NAME##_range_omp
+#else
+#define MC_ENGINE_RANGE_MPI(NAME) NAME##_range
+#endif
+#define MC_ENGINE_MPI(NAME, P)                                                \
+static inline void NAME##_run_mpi(uint64_t seed, uint64_t N, const P *p,      \
+                                  MPI_Comm comm, mc_acc_t *acc) {             \
+    mc_engine_job_t job_ = { seed, p };                                       \
+    uint64_t t_[2];                                                           \
+    mc_mpi_run(N, MC_ENGINE_RANGE_MPI(NAME), &job_, comm, t_);                \
+    mc_acc_from_hits(acc, t_);                                                \
+}
+#else
+#define MC_ENGINE_MPI(NAME, P)
+#endif
+
+// Lo propio de un estimador HITS: media/error, cuerpo común, NAME_range y
+// los backends de contadores. Para un NAME_sub escrito a mano que cuenta
+// aciertos (ver mc_engine_dart_mode)
+#define MC_ENGINE_HITS(NAME, P)                                               \
+static inline double NAME##_mean(const mc_acc_t *a)   { return mc_acc_hits_mean(a); }   \
+static inline double NAME##_stderr(const mc_acc_t *a) { return mc_acc_hits_stderr(a); } \
+MC_ENGINE_COMMON(NAME, P)                                                     \
+static inline void NAME##_range(uint64_t a, uint64_t b, uint64_t acc[2], const void *job) { \
+    const mc_engine_job_t *j_ = (const mc_engine_job_t*)job;                  \
+    mc_acc_t s_ = {0, 0, 0.0, 0.0};                                           \
+    NAME##_stream(j_->seed, a, b, (const P*)j_->p, &s_);                      \
+    acc[0] += s_.hits;                                                        \
+    acc[1] += s_.n;                                                           \
+}                                                                             \
+MC_ENGINE_RANGE_OMP(NAME, P)                                                  \
+MC_ENGINE_THREADS(NAME, P)                                                    \
+MC_ENGINE_MPI(NAME, P)
+
+#define MC_DEFINE_HITS_ESTIMATOR(NAME, DIM, P, KERNEL)                        \
+static inline void NAME##_sub(xr_simd_t *r, size_t lo, size_t hi,            \
+                              const P *p, mc_acc_t *acc) {                    \
+    MC_ENGINE_FILL(DIM)                                                       \
+    acc->hits += KERNEL(u, lo, hi, p);                                        \
+    acc->n    += hi - lo;                                                     \
+}                                                                             \
+MC_ENGINE_HITS(NAME, P)
+
+#define MC_DEFINE_SUM_ESTIMATOR(NAME, DIM, P, KERNEL)                         \
+static inline void NAME##_sub(xr_simd_t *r, size_t lo, size_t hi,            \
+                              const P *p, mc_acc_t *acc) {                    \
+    MC_ENGINE_FILL(DIM)                                                       \
+    double s_ = 0.0, s2_ = 0.0;                                               \
+    KERNEL(u, lo, hi, p, &s_, &s2_);                                          \
+    acc->sum  += s_;                                                          \
+    acc->sum2 += s2_;                                                         \
+    acc->n    += hi - lo;                                                     \
+}                                                                             \
+static inline double NAME##_mean(const mc_acc_t *a)   { return mc_acc_sum_mean(a); }   \
+static inline double NAME##_stderr(const mc_acc_t *a) { return mc_acc_sum_stderr(a); } \
+MC_ENGINE_COMMON(NAME, P)
+
+#define MC_DEFINE_HITS_ESTIMATOR_DYN(NAME, P, KERNEL)                        \
+static inline void NAME##_sub(xr_simd_t *r, size_t lo, size_t hi,            \
+                              const P *p, mc_acc_t *acc) {                    \
+    MC_ENGINE_FILL_DYN(p->d)                                                  \
+    acc->hits += KERNEL(u, lo, hi, p);                                        \
+    acc->n    += hi - lo;                                                     \
+}                                                                             \
+MC_ENGINE_HITS(NAME, P)
+
+#define MC_DEFINE_SUM_ESTIMATOR_DYN(NAME, P, KERNEL)                         \
+static inline void NAME##_sub(xr_simd_t *r, size_t lo, size_t hi,            \
+                              const P *p, mc_acc_t *acc) {                    \
+    MC_ENGINE_FILL_DYN(p->d)                                                  \
+    double s_ = 0.0, s2_ = 0.0;                                               \
+    KERNEL(u, lo, hi, p, &s_, &s2_);                                          \
+    acc->sum  += s_;                                                          \
+    acc->sum2 += s2_;                                                         \
+    acc->n    += hi - lo;                                                     \
+}                                                                             \
+static inline double NAME##_mean(const mc_acc_t *a)   { return mc_acc_sum_mean(a); }   \
+static inline double NAME##_stderr(const mc_acc_t *a) { return mc_acc_sum_stderr(a); } \
+MC_ENGINE_COMMON(NAME, P)
+
+// ---- estimadores de pi incluidos ----
+// Cada uno: parámetros, kernel y una línea de macro.
+
+// Dardo: P(x^2 + y^2 <= 1) = pi/4
+typedef struct { int unused; } mc_engine_dart_p;
+
+static inline uint64_t mc_engine_dart_k(const double *const *u, size_t lo, size_t hi,
+                                        const mc_engine_dart_p *p) {
+    (void)p;
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i)
+        c += (u[0][i]*u[0][i] + u[1][i]*u[1][i] <= 1.0);
+    return c;
+}
+MC_DEFINE_HITS_ESTIMATOR(mc_engine_dart, 2, mc_engine_dart_p, mc_engine_dart_k)
+
+// Dardo en el modo de HPC_DART (MC_DART_INT | DOUBLE | FLOAT): bloque propio,
+// el sub-bloque de mc_kernels.h tal cual (mismo conteo que mc_dart_count_stream)
+typedef struct { int mode; } mc_engine_dart_mode_p;
+
+static inline void mc_engine_dart_mode_sub(xr_simd_t *r, size_t lo, size_t hi,
+                                           const mc_engine_dart_mode_p *p, mc_acc_t *acc) {
+    acc->hits += mc_dart_sub(r, lo, hi, p->mode);
+    acc->n    += hi - lo;
+}
+MC_ENGINE_HITS(mc_engine_dart_mode, mc_engine_dart_mode_p)
+
+// Buffon: theta = (pi/2) u0, distancia = (D/2) u1; P(cruce) = 2L / (pi D)
+typedef struct { double half_L, half_D; } mc_engine_buffon_p;
+
+static inline uint64_t mc_engine_buffon_k(const double *const *u, size_t lo, size_t hi,
+                                          const mc_engine_buffon_p *p) {
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i)
+        c += (p->half_D * u[1][i] <= p->half_L * mc_sin_poly(MC_PI_HALF * u[0][i]));
+    return c;
+}
+MC_DEFINE_HITS_ESTIMATOR(mc_engine_buffon, 2, mc_engine_buffon_p, mc_engine_buffon_k)
+
+// Integral: pi = int_0^1 4 / (1 + x^2) dx
+typedef struct { int unused; } mc_engine_atan_p;
+
+static inline void mc_engine_atan_k(const double *const *u, size_t lo, size_t hi,
+                                    const mc_engine_atan_p *p, double *s, double *s2) {
+    (void)p;
+    double a = 0.0, a2 = 0.0;
+    for (size_t i = lo; i < hi; ++i) {
+        double f = 4.0 / (1.0 + u[0][i]*u[0][i]);
+        a += f;
+        a2 += f * f;
+    }
+    *s += a;
+    *s2 += a2;
+}
+MC_DEFINE_SUM_ESTIMATOR(mc_engine_atan, 1, mc_engine_atan_p, mc_engine_atan_k)
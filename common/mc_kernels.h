@@ -0,0 +1,312 @@
+// mc_kernels.h — kernels por bloques de Monte Carlo para pi (dardo y aguja de Buffon)
+//
+// Consumen rng_simd.h: cada bloque de XR_BLOCK muestras se genera de una vez
+// (x[], y[] en L1) y luego se cuenta con un bucle sin dependencias entre
+// muestras, vectorizable. Los programas de Reto1 y Reto2 solo reparten el
+// rango de muestras y llaman a estas funciones.
+//
+//   dart     aciertos con x^2 + y^2 <= 1,  x,y ~ U[0,1)
+//   buffon   cruces con y <= (L/2) sin(theta),  y ~ U[0,D/2),
+//            theta ~ U[0,pi/2)  (sin|θ| en [0,pi) tiene la misma ley)
+//   buffon_f igual en float (Reto2)
+//
+// Dardo (mode, elegido con HPC_DART vía mc_dart_mode_from_env):
+//   int     (por defecto) UN valor de 64 bits por dardo: x = 31 bits altos,
+//           y = bits 2..32 (los 2 bits bajos de xoshiro256+ son los débiles);
+//           acierto si x^2 + y^2 < 2^62, todo en enteros sin desbordar
+//           (2*(2^31-1)^2 < 2^63). Es el mismo test que en double con
+//           x,y en la malla k/2^31: mismo reparto salvo el sesgo de
+//           discretización, O(2^-31) relativo, muy por debajo del error estadístico
+//   double  dos valores de 64 bits -> dos doubles en [0,1) por dardo
+//   float   UN valor de 64 bits -> dos floats (x, y) por dardo; el test va en
+//           float con 16 carriles por vector (el doble que double). x,y caen
+//           en la malla k/2^23: con el punto izquierdo de la celda el sesgo de
+//           pi sería ~4/2^23 = 4.8e-7, por eso se toma el punto medio
+//           (k + 1/2)/2^23 (MC_MID_F), que lo cancela a primer orden
+//
+// Seno de Buffon (mode, elegido con HPC_BUFFON_SIN vía mc_sin_mode_from_env):
+//   poly    polinomio minimax impar en [0,pi/2] (por defecto): solo mul/add,
+//           se vectoriza; error máx. medido ~1e-15 (double, grado 15) y
+//           ~2e-7 (float, grado 9: 4e-9 de aproximación + redondeo en float).
+//           Reto2/Buffon_sincheck.c lo mide y compara cruces contra libm
+//   libm    sin()/sinf() de la libm, llamada escalar por muestra (referencia)
+//   reject  sin trigonometría: dirección (u,v) uniforme en el cuarto de disco
+//           por rechazo, sin(theta) = v/|(u,v)|; la comparación se hace al
+//           cuadrado, sin sqrt. Una muestra = una propuesta; solo las
+//           aceptadas (~pi/4) son agujas y se devuelven en *needles
+//
+// Precisión (HPC_MC_PREC=double|float, mc_prec_from_env): en el dardo elige
+// el modo double/float (sin la variable manda HPC_DART, int por defecto); en
+// Buffon elige mc_buffon_sub (double) o mc_buffon_sub_f (float, por defecto en
+// Reto2) y va como el bit MC_BUFFON_DOUBLE dentro de mode, así el modo entero
+// identifica el kernel (mc_buffon_count_stream_m despacha). Float usa los 16
+// carriles de un vector de 512 bits (8 en double) y gasta la mitad de bits
+// aleatorios por muestra. Sesgo frente a double: nota junto a
+// mc_buffon_count_stream_m.
+//
+// Dos formas de cada kernel:
+//   mc_<k>_count(&R, n, ...)          n muestras de un generador propio
+//   mc_<k>_count_stream(seed, a, b, ...) muestras [a,b) del flujo reproducible
+//                                     de rng_stream.h: mismo resultado para
+//                                     cualquier reparto entre trabajadores
+//
+// Dentro de un sub-bloque se generan siempre XR_BLOCK muestras y se cuentan
+// solo las de [lo,hi); así el generador avanza igual aunque se usen menos.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "rng_simd.h"
+#include "rng_stream.h"
+
+#define MC_PI_HALF  1.57079632679489661923
+
+// ---- precisión ----
+enum { MC_PREC_AUTO = 0, MC_PREC_DOUBLE = 1, MC_PREC_FLOAT = 2 };
+
+// Sin variable: MC_PREC_AUTO (cada kernel con su defecto); -1 si no es válida
+static inline int mc_prec_from_env(void) {
+    const char *e = getenv("HPC_MC_PREC");
+    if (!e || !*e) return MC_PREC_AUTO;
+    if (strcmp(e, "double") == 0) return MC_PREC_DOUBLE;
+    if (strcmp(e, "float") == 0)  return MC_PREC_FLOAT;
+    return -1;
+}
+
+static inline const char* mc_prec_name(int prec) {
+    return prec == MC_PREC_DOUBLE ? "double" : (prec == MC_PREC_FLOAT ? "float" : "auto");
+}
+
+// ---- dardo ----
+enum { MC_DART_INT = 0, MC_DART_DOUBLE = 1, MC_DART_FLOAT = 2 };
+
+// HPC_DART=int|double|float; HPC_MC_PREC sin HPC_DART elige double/float.
+// -1 si no es válido o si las dos variables se contradicen
+static inline int mc_dart_mode_from_env(void) {
+    const char *e = getenv("HPC_DART");
+    int prec = mc_prec_from_env();
+    if (prec < 0) return -1;
+    if (!e || !*e) return prec == MC_PREC_DOUBLE ? MC_DART_DOUBLE
+                        : prec == MC_PREC_FLOAT ? MC_DART_FLOAT : MC_DART_INT;
+    if (strcmp(e, "int") == 0)    return prec == MC_PREC_AUTO   ? MC_DART_INT : -1;
+    if (strcmp(e, "double") == 0) return prec != MC_PREC_FLOAT  ? MC_DART_DOUBLE : -1;
+    if (strcmp(e, "float") == 0)  return prec != MC_PREC_DOUBLE ? MC_DART_FLOAT : -1;
+    return -1;
+}
+
+static inline const char* mc_dart_mode_name(int mode) {
+    return mode == MC_DART_DOUBLE ? "double" : (mode == MC_DART_FLOAT ? "float" : "int");
+}
+
+// ---- seno de Buffon ----
+enum { MC_SIN_POLY = 0, MC_SIN_LIBM = 1, MC_SIN_REJECT = 2 };
+
+static inline int mc_sin_mode_from_env(void) {
+    const char *e = getenv("HPC_BUFFON_SIN");
+    if (!e || !*e || strcmp(e, "poly") == 0) return MC_SIN_POLY;
+    if (strcmp(e, "libm") == 0)   return MC_SIN_LIBM;
+    if (strcmp(e, "reject") == 0) return MC_SIN_REJECT;
+    return -1;
+}
+
+// Bit de precisión dentro del modo de Buffon (ver mc_buffon_count_stream_m)
+#define MC_BUFFON_DOUBLE 0x10
+
+static inline const char* mc_sin_mode_name(int mode) {
+    mode &= ~MC_BUFFON_DOUBLE;
+    return mode == MC_SIN_LIBM ? "libm" : (mode == MC_SIN_REJECT ? "reject" : "poly");
+}
+
+// Modo de seno | MC_BUFFON_DOUBLE si HPC_MC_PREC=double (float por defecto)
+static inline int mc_buffon_mode_from_env(void) {
+    int mode = mc_sin_mode_from_env(), prec = mc_prec_from_env();
+    if (mode < 0 || prec < 0) return -1;
+    return mode | (prec == MC_PREC_DOUBLE ? MC_BUFFON_DOUBLE : 0);
+}
+
+// Coeficientes Remez (error absoluto) de sin(x) = x * q(x^2) en [0, pi/2]
+static inline double mc_sin_poly(double x) {
+    double x2 = x * x;
+    double q = -7.40807009885378961292e-13;
+    q = q * x2 + 1.60510252425070345462e-10;
+    q = q * x2 - 2.50519758324890675276e-08;
+    q = q * x2 + 2.75573181090593278110e-06;
+    q = q * x2 - 1.98412698368210941094e-04;
+    q = q * x2 + 8.33333333332638738489e-03;
+    q = q * x2 - 1.66666666666666379859e-01;
+    q = q * x2 + 1.0;
+    return x * q;
+}
+
+static inline float mc_sinf_poly(float x) {
+    float x2 = x * x;
+    float q = 2.59048854391606281027e-06f;
+    q = q * x2 - 1.98008977868148168880e-04f;
+    q = q * x2 + 8.33289982379015886638e-03f;
+    q = q * x2 - 1.66666476346690767274e-01f;
+    q = q * x2 + 9.99999976589931116600e-01f;
+    return x * q;
+}
+
+// ---- sub-bloques: XR_BLOCK muestras generadas, contadas las de [lo,hi) ----
+// Punto medio de la celda de la malla k/2^23 de xr_simd_fill01f (exacto: la
+// malla es más gruesa que el ulp en [0,1))
+#define MC_MID_F(v) ((v) + 0x1p-24f)
+
+static inline uint64_t mc_dart_sub(xr_simd_t *r, size_t lo, size_t hi, int mode) {
+    uint64_t c = 0;
+    if (mode == MC_DART_INT) {
+        _Alignas(64) uint64_t u[XR_BLOCK];
+        xr_simd_fill_u64(r, u, XR_BLOCK);
+        for (size_t i = lo; i < hi; ++i) {
+            uint64_t x = u[i] >> 33;
+            uint64_t y = (u[i] >> 2) & 0x7FFFFFFFu;
+            c += (x*x + y*y < (1ULL << 62));
+        }
+        return c;
+    }
+    if (mode == MC_DART_FLOAT) {
+        // contador de 32 bits: mismo ancho que el float, 16 carriles por vector.
+        // x^2 <= 1 - y^2 y no x^2 + y^2 <= 1: la suma redondea a 1.0 justo en
+        // el cambio de binade y contaría de más (sesgo ~2e-7 en pi)
+        _Alignas(64) float x[XR_BLOCK], y[XR_BLOCK];
+        xr_simd_fill01f(r, x, XR_BLOCK);
+        xr_simd_fill01f(r, y, XR_BLOCK);
+        uint32_t c32 = 0;
+        for (size_t i = lo; i < hi; ++i) {
+            float xi = MC_MID_F(x[i]), yi = MC_MID_F(y[i]);   // punto medio, exacto
+            c32 += (xi*xi <= 1.0f - yi*yi);
+        }
+        return c32;
+    }
+    _Alignas(64) double x[XR_BLOCK], y[XR_BLOCK];
+    xr_simd_fill01(r, x, XR_BLOCK);
+    xr_simd_fill01(r, y, XR_BLOCK);
+    for (size_t i = lo; i < hi; ++i)
+        c += (x[i]*x[i] + y[i]*y[i] <= 1.0);
+    return c;
+}
+
+// Un solo cuerpo para double y float (T, FILL, SIN, POLY)
+#define MC_DEFINE_BUFFON_SUB(NAME, T, FILL, SIN, POLY)                            \
+static inline uint64_t NAME(xr_simd_t *r, size_t lo, size_t hi, T half_L, T half_D, \
+                            int mode, uint64_t *needles) {                        \
+    _Alignas(64) T th[XR_BLOCK], y[XR_BLOCK];                                     \
+    uint32_t c = 0;     /* 32 bits: no ensancha los carriles de float */          \
+    if (mode == MC_SIN_REJECT) {                                                  \
+        _Alignas(64) T v[XR_BLOCK];                                               \
+        FILL(r, th, XR_BLOCK);   /* u */                                          \
+        FILL(r, v,  XR_BLOCK);                                                    \
+        FILL(r, y,  XR_BLOCK);                                                    \
+        uint32_t acc = 0;                                                         \
+        for (size_t i = lo; i < hi; ++i) {                                        \
+            T r2 = th[i]*th[i] + v[i]*v[i];                                       \
+            int in = (r2 <= (T)1) & (r2 > (T)0);                                  \
+            T dy = half_D * y[i], lv = half_L * v[i];                             \
+            acc += in;                                                            \
+            c   += in & (dy*dy*r2 <= lv*lv);                                      \
+        }                                                                         \
+        *needles += acc;                                                          \
+        return c;                                                                 \
+    }                                                                             \
+    FILL(r, th, XR_BLOCK);                                                        \
+    FILL(r, y,  XR_BLOCK);                                                        \
+    if (mode == MC_SIN_LIBM)                                                      \
+        for (size_t i = lo; i < hi; ++i) th[i] = SIN((T)MC_PI_HALF * th[i]);      \
+    else                                                                          \
+        for (size_t i = lo; i < hi; ++i) th[i] = POLY((T)MC_PI_HALF * th[i]);     \
+    for (size_t i = lo; i < hi; ++i)                                              \
+        c += (half_D * y[i] <= half_L * th[i]);                                   \
+    *needles += hi - lo;                                                          \
+    return c;                                                                     \
+}
+
+MC_DEFINE_BUFFON_SUB(mc_buffon_sub,   double, xr_simd_fill01,  sin,  mc_sin_poly)
+MC_DEFINE_BUFFON_SUB(mc_buffon_sub_f, float,  xr_simd_fill01f, sinf, mc_sinf_poly)
+
+// ---- n muestras de un generador propio ----
+#define MC_COUNT_LOOP(SUB, ...)                                   \
+    uint64_t acc = 0;                                             \
+    while (n) {                                                   \
+        size_t m = n < XR_BLOCK ? (size_t)n : XR_BLOCK;           \
+        acc += SUB(r, 0, m, ##__VA_ARGS__);                       \
+        n   -= m;                                                 \
+    }                                                             \
+    return acc
+
+static inline uint64_t mc_dart_count(xr_simd_t *r, uint64_t n, int mode) {
+    MC_COUNT_LOOP(mc_dart_sub, mode);
+}
+
+// needles (puede ser NULL): agujas lanzadas, igual a n salvo en modo reject
+static inline uint64_t mc_buffon_count(xr_simd_t *r, uint64_t n, double L, double D,
+                                       int mode, uint64_t *needles) {
+    uint64_t nd_ = 0;
+    if (!needles) needles = &nd_;
+    MC_COUNT_LOOP(mc_buffon_sub, 0.5 * L, 0.5 * D, mode, needles);
+}
+
+static inline uint64_t mc_buffon_count_f(xr_simd_t *r, uint64_t n, float L, float D,
+                                         int mode, uint64_t *needles) {
+    uint64_t nd_ = 0;
+    if (!needles) needles = &nd_;
+    MC_COUNT_LOOP(mc_buffon_sub_f, 0.5f * L, 0.5f * D, mode, needles);
+}
+
+// ---- muestras [a,b) del flujo reproducible (semilla, índice de muestra) ----
+#define MC_STREAM_LOOP(SUB, ...)                                          \
+    uint64_t acc = 0;                                                     \
+    for (uint64_t blk = a / MC_STREAM_BLOCK; blk * MC_STREAM_BLOCK < b; ++blk) { \
+        xr_simd_t r_;                                                     \
+        xr_simd_seed_block(&r_, seed, blk);                               \
+        uint64_t base = blk * MC_STREAM_BLOCK;                            \
+        for (uint64_t o = 0; o < MC_STREAM_BLOCK && base + o < b; o += XR_BLOCK) { \
+            uint64_t s0 = base + o, s1 = s0 + XR_BLOCK;                   \
+            size_t lo = a <= s0 ? 0 : (a < s1 ? (size_t)(a - s0) : XR_BLOCK); \
+            size_t hi = b >= s1 ? XR_BLOCK : (size_t)(b - s0);            \
+            acc += SUB(&r_, lo, hi < lo ? lo : hi, ##__VA_ARGS__);        \
+        }                                                                 \
+    }                                                                     \
+    return acc
+
+static inline uint64_t mc_dart_count_stream(uint64_t seed, uint64_t a, uint64_t b, int mode) {
+    MC_STREAM_LOOP(mc_dart_sub, mode);
+}
+
+static inline uint64_t mc_buffon_count_stream(uint64_t seed, uint64_t a, uint64_t b,
+                                              double L, double D,
+                                              int mode, uint64_t *needles) {
+    uint64_t nd_ = 0;
+    if (!needles) needles = &nd_;
+    MC_STREAM_LOOP(mc_buffon_sub, 0.5 * L, 0.5 * D, mode, needles);
+}
+
+static inline uint64_t mc_buffon_count_stream_f(uint64_t seed, uint64_t a, uint64_t b,
+                                                float L, float D,
+                                                int mode, uint64_t *needles) {
+    uint64_t nd_ = 0;
+    if (!needles) needles = &nd_;
+    MC_STREAM_LOOP(mc_buffon_sub_f, 0.5f * L, 0.5f * D, mode, needles);
+}
+
+// Buffon en la precisión que indica mode (bit MC_BUFFON_DOUBLE).
+//
+// Sesgo de float medido con Reto2/Prec_check.c (N = 1e9, 3 semillas; pareado:
+// mismas muestras en aritmética float y double):
+//   dart    ~+5e-8 en pi (12-19 muestras cambian de lado); sin el punto medio
+//           serían +4.6e-7 más
+//   buffon  ~-2.5e-7 en pi (~50 muestras, todas del mismo lado: mc_sinf_poly
+//           redondeado queda en promedio por encima de sin)
+// El error estándar de pi es ~1.6/sqrt(N) (dardo) y ~2.4/sqrt(N) (Buffon):
+// el sesgo de float solo se vería con N >~ 1e13 en Buffon y más aún en el
+// dardo. Contra pi_double la diferencia da |z| < 1.5 en todas las pruebas.
+// Velocidad (1 hilo, AVX-512): float 1.4x (dardo) y 2x (Buffon) más rápido.
+static inline uint64_t mc_buffon_count_stream_m(uint64_t seed, uint64_t a, uint64_t b,
+                                                double L, double D,
+                                                int mode, uint64_t *needles) {
+    if (mode & MC_BUFFON_DOUBLE)
+        return mc_buffon_count_stream(seed, a, b, L, D, mode & ~MC_BUFFON_DOUBLE, needles);
+    return mc_buffon_count_stream_f(seed, a, b, (float)L, (float)D, mode, needles);
+}
@@ -0,0 +1,101 @@
+// mc_mpi.h — Monte Carlo repartido entre ranks MPI (con OpenMP dentro de cada rank)
+//
+// Flujos: todos los ranks usan el MISMO flujo reproducible (rng_stream.h) y
+// cada uno cuenta un tramo disjunto de índices de muestra, alineado a
+// bloques; los hilos del rank subdividen su tramo igual. Los números de cada
+// muestra no dependen de R ni de T: el conteo es idéntico al de _seq/_omp.
+//
+// Dos formas (la función range(a, b, acc, ctx) suma en acc[0] aciertos/cruces
+// y en acc[1] muestras/agujas del tramo [a,b)):
+//
+//   mc_mpi_run         N fijo: el rank r cuenta mc_stream_split(N, R, r) y se
+//                      combina con un solo MPI_Reduce a rank 0
+//   mc_mpi_run_target  HPC_MC_TARGET: rondas de MC_MPI_ROUND muestras por
+//                      rank (ronda k, rank r -> lote k*R + r, así lo usado es
+//                      un prefijo del flujo). Tras cada ronda se lanza un
+//                      MPI_Iallreduce de los acumulados y se calcula la
+//                      siguiente mientras viaja; al completarse, todos ven los
+//                      mismos totales y paran en la misma ronda si el error
+//                      estándar (mc_adaptive.h) ya bajó del objetivo. Al final
+//                      también un MPI_Reduce, que además deja en *used las
+//                      posiciones del flujo recorridas (= acc[1] salvo en
+//                      Buffon reject, donde acc[1] son solo las aceptadas)
+//
+// HPC_MPI_WEAK=1 (mc_mpi_weak_from_env): los programas toman N por rank
+// (escalamiento débil: el trabajo por rank no cambia con R).
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include "rng_stream.h"
+#include "mc_adaptive.h"
+
+#define MC_MPI_ROUND (64u * MC_STREAM_BLOCK)   // muestras por rank y ronda (~1M)
+
+typedef void (*mc_mpi_range_fn)(uint64_t a, uint64_t b, uint64_t acc[2], const void *ctx);
+
+static inline int mc_mpi_weak_from_env(void) {
+    const char *e = getenv("HPC_MPI_WEAK");
+    return e && e[0] == '1';
+}
+
+// Sub-tramo p de `parts` dentro de [a,b), a alineado a MC_STREAM_BLOCK
+static inline void mc_mpi_subrange(uint64_t a, uint64_t b, uint64_t parts, uint64_t p,
+                                   uint64_t *x, uint64_t *y) {
+    mc_stream_split(b - a, parts, p, x, y);
+    *x += a;
+    *y += a;
+}
+
+static inline void mc_mpi_run(uint64_t N, mc_mpi_range_fn range, const void *ctx,
+                              MPI_Comm comm, uint64_t tot[2]) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    uint64_t a, b, acc[2] = {0, 0};
+    mc_stream_split(N, (uint64_t)size, (uint64_t)rank, &a, &b);
+    if (a < b) range(a, b, acc, ctx);
+    MPI_Reduce(acc, tot, 2, MPI_UINT64_T, MPI_SUM, 0, comm);
+}
+
+static inline void mc_mpi_run_target(uint64_t N, double target, int kind, double ratio,
+                                     mc_mpi_range_fn range, const void *ctx,
+                                     MPI_Comm comm, uint64_t tot[2], uint64_t *used) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    uint64_t acc[2] = {0, 0}, snap[2], glob[2], pos = 0;
+    MPI_Request req = MPI_REQUEST_NULL;
+    for (uint64_t k = 0;; ++k) {
+        uint64_t a = (k * (uint64_t)size + (uint64_t)rank) * MC_MPI_ROUND;
+        if (a < N) {
+            uint64_t b = a + MC_MPI_ROUND < N ? a + MC_MPI_ROUND : N;
+            range(a, b, acc, ctx);
+            pos += b - a;
+        }
+        int stop = 0;
+        if (req != MPI_REQUEST_NULL) {
+            // totales de la ronda anterior: iguales en todos los ranks
+            MPI_Wait(&req, MPI_STATUS_IGNORE);
+            stop = glob[1] >= MC_ADAPT_MIN_N && glob[0] <= glob[1] &&
+                   mc_pi_stderr(kind, glob[0], glob[1], ratio) <= target;
+        }
+        if (stop || (k + 1) * (uint64_t)size * MC_MPI_ROUND >= N) break;
+        snap[0] = acc[0]; snap[1] = acc[1];
+        MPI_Iallreduce(snap, glob, 2, MPI_UINT64_T, MPI_SUM, comm, &req);
+    }
+    if (req != MPI_REQUEST_NULL) MPI_Wait(&req, MPI_STATUS_IGNORE);
+    uint64_t loc[3] = {acc[0], acc[1], pos}, fin[3];
+    MPI_Reduce(loc, fin, 3, MPI_UINT64_T, MPI_SUM, 0, comm);
+    tot[0] = fin[0];
+    tot[1] = fin[1];
+    if (used) *used = fin[2];
+}
+
+// Columnas extra en modo objetivo, como mc_adapt_report
+static inline void mc_mpi_report(FILE *f, int kind, const uint64_t tot[2],
+                                 double target, double ratio) {
+    mc_pi_report(f, kind, tot[0], tot[1], target, ratio);
+}
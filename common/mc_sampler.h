@@ -0,0 +1,261 @@
+// mc_sampler.h — muestreadores con reducción de varianza y cuasi-Monte Carlo
+//
+// Con muestras i.i.d. el error de pi baja como O(1/sqrt(N)): para un dígito
+// más hacen falta 100x muestras. Aquí se cambia CÓMO se colocan los puntos
+// (x,y) en [0,1)^2, no el test de acierto/cruce:
+//
+//   iid     xoshiro256+ del flujo reproducible (lo de mc_kernels.h en double)
+//   strat   estratificado: cada bloque del flujo (MC_STREAM_BLOCK = 128x128
+//           muestras) pone exactamente un punto en cada celda de la malla
+//           128x128, con desplazamiento uniforme dentro de la celda
+//   anti    antitético: la muestra impar es (1-x, 1-y) de la par anterior;
+//           el test es monótono en x e y, así el par está anticorrelacionado,
+//           pero para estos indicadores la correlación es débil: la ganancia
+//           medida es ~1x (queda como referencia)
+//   sobol   Sobol 2D (van der Corput + 2a dimensión de Sobol), con
+//           aleatorización de Owen por hash (Burley 2020, "Practical
+//           hash-based Owen scrambling"); semilla distinta por dimensión
+//   halton  Halton bases 2 y 3, con Owen anidado: el dígito k se permuta con
+//           una permutación de {0,1,2} elegida por hash de (semilla, k,
+//           dígitos anteriores)
+//
+// Todos son direccionables por índice de muestra: el punto i depende solo de
+// (semilla, i), así cualquier rango [a,b) se calcula sin estado previo y el
+// reparto entre hilos/procesos no cambia el resultado (igual que rng_stream.h).
+// Sobol/Halton usan índice de 32 bits: cada tramo de 2^32 muestras es un
+// conjunto aleatorizado nuevo (semilla mezclada con i >> 32).
+//
+// Medido con Reto2/mc_sampler_bench.c (1 hilo, N = 2^24, rmse^2 * tiempo
+// relativo a iid): strat ~1/70, sobol ~1/500-1/1000, halton ~1/100-1/500.
+// El tiempo por muestra de sobol es ~6x el de iid y el de halton ~20x.
+//
+// Error: strat y anti dan estimadores insesgados con varianza <= iid;
+// el error estándar binomial de mc_adaptive.h los sobreestima (conservador).
+// sobol/halton aleatorizados son insesgados y convergen casi como O(1/N),
+// pero su error solo se estima con réplicas de semilla (ver
+// Reto2/mc_sampler_bench.c), por eso no se combinan con HPC_MC_TARGET.
+//
+// Se elige con HPC_MC_SAMPLER=iid|strat|anti|sobol|halton (mc_sampler_from_env).
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mc_kernels.h"
+
+enum { MC_SAMPLER_IID = 0, MC_SAMPLER_STRAT, MC_SAMPLER_ANTI,
+       MC_SAMPLER_SOBOL, MC_SAMPLER_HALTON, MC_SAMPLER_COUNT };
+
+#define MC_STRAT_K 128        // malla MC_STRAT_K x MC_STRAT_K por bloque del flujo
+_Static_assert(MC_STRAT_K * MC_STRAT_K == MC_STREAM_BLOCK, "un bloque = una malla completa");
+_Static_assert(XR_BLOCK % 2 == 0, "los pares antitéticos no cruzan sub-bloques");
+
+static const char *const mc_sampler_names[MC_SAMPLER_COUNT] = {
+    "iid", "strat", "anti", "sobol", "halton"
+};
+
+// Sin variable: iid; -1 si el valor no es válido
+static inline int mc_sampler_from_env(void) {
+    const char *e = getenv("HPC_MC_SAMPLER");
+    if (!e || !*e) return MC_SAMPLER_IID;
+    for (int s = 0; s < MC_SAMPLER_COUNT; ++s)
+        if (strcmp(e, mc_sampler_names[s]) == 0) return s;
+    return -1;
+}
+
+static inline const char* mc_sampler_name(int s) {
+    return (s >= 0 && s < MC_SAMPLER_COUNT) ? mc_sampler_names[s] : "?";
+}
+
+// ---- Owen por hash ----
+static inline uint32_t mc_reverse32(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    return __builtin_bswap32(x);
+}
+
+// Permutación de Laine-Karras: cada bit solo depende de los bits más bajos;
+// aplicada sobre los bits invertidos es un scramble de Owen (base 2)
+static inline uint32_t mc_owen2(uint32_t x, uint32_t seed) {
+    x = mc_reverse32(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return mc_reverse32(x);
+}
+
+static inline uint64_t mc_hash64(uint64_t x) {
+    return xr_splitmix64(&x);
+}
+
+// Semilla de scramble por (semilla, dimensión, tramo de 2^32)
+static inline uint64_t mc_dim_seed(uint64_t seed, uint32_t dim, uint64_t hi) {
+    return mc_hash64(seed ^ mc_hash64(((uint64_t)dim << 56) ^ hi));
+}
+
+// ---- secuencias ----
+// Sobol en orden de código Gray: la muestra k usa el punto g = k ^ (k >> 1)
+// (mismo conjunto de puntos por cada potencia de 2). Así k+1 sale de k con un
+// xor por dimensión, y el primer punto de un sub-bloque se calcula directo.
+// Dimensión 0: van der Corput (V[j] = 2^(31-j)); dimensión 1: polinomio x+1,
+// V[j+1] = V[j] ^ (V[j] >> 1).
+static const uint32_t mc_sobol2_v[32] = {
+    0x80000000u, 0xc0000000u, 0xa0000000u, 0xf0000000u, 0x88000000u, 0xcc000000u, 0xaa000000u, 0xff000000u,
+    0x80800000u, 0xc0c00000u, 0xa0a00000u, 0xf0f00000u, 0x88880000u, 0xcccc0000u, 0xaaaa0000u, 0xffff0000u,
+    0x80008000u, 0xc000c000u, 0xa000a000u, 0xf000f000u, 0x88008800u, 0xcc00cc00u, 0xaa00aa00u, 0xff00ff00u,
+    0x80808080u, 0xc0c0c0c0u, 0xa0a0a0a0u, 0xf0f0f0f0u, 0x88888888u, 0xccccccccu, 0xaaaaaaaau, 0xffffffffu
+};
+
+static inline uint32_t mc_sobol2(uint32_t g) {
+    uint32_t x = 0;
+    for (unsigned j = 0; g; g >>= 1, ++j)
+        if (g & 1) x ^= mc_sobol2_v[j];
+    return x;
+}
+
+// Inverso radical en base 3 con Owen anidado, 21 dígitos (3^-21 < 2^-33), de
+// n <= XR_BLOCK índices a la vez (el bucle interno va sobre las muestras y se
+// vectoriza). La cola también se aleatoriza aunque el índice ya no tenga
+// dígitos. h resume (semilla, dígitos originales anteriores) y elige la
+// permutación del nivel: las 6 permutaciones de {0,1,2} son exactamente
+// d -> (a d + b) mod 3 con a en {1,2}, b en {0,1,2}, así no hace falta tabla
+static inline void mc_halton3_owen(const uint32_t * __restrict idx, uint32_t seed,
+                                   double * __restrict out, size_t n) {
+    _Alignas(64) uint32_t i3[XR_BLOCK], h[XR_BLOCK];
+    _Alignas(64) double acc[XR_BLOCK];
+    for (size_t i = 0; i < n; ++i) { i3[i] = idx[i]; h[i] = seed; acc[i] = 0.0; }
+    double f = 1.0 / 3.0;
+    for (int k = 0; k < 21; ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t q = i3[i] / 3u, d = i3[i] - 3u * q;
+            uint32_t a = 1u + (h[i] >> 31), b = (h[i] & 0xFFFFu) % 3u;
+            acc[i] += f * (double)((a * d + b) % 3u);
+            i3[i] = q;
+            uint32_t t = (h[i] ^ (d + 1u)) * 0x9e3779b1u;
+            h[i] = t ^ (t >> 15);
+        }
+        f *= 1.0 / 3.0;
+    }
+    memcpy(out, acc, n * sizeof *out);
+}
+
+#define MC_U32_TO_01  (1.0 / 4294967296.0)
+
+// ---- puntos: XR_BLOCK puntos (x,y) de las muestras base .. base+XR_BLOCK-1 ----
+// r es el generador del bloque del flujo (solo lo usan iid/strat/anti);
+// base es múltiplo de XR_BLOCK
+static inline void mc_sampler_points(int s, xr_simd_t *r, uint64_t seed, uint64_t base,
+                                     double * __restrict x, double * __restrict y) {
+    switch (s) {
+    case MC_SAMPLER_STRAT: {
+        xr_simd_fill01(r, x, XR_BLOCK);
+        xr_simd_fill01(r, y, XR_BLOCK);
+        uint32_t j0 = (uint32_t)(base % MC_STREAM_BLOCK);
+        for (size_t i = 0; i < XR_BLOCK; ++i) {
+            uint32_t j = j0 + (uint32_t)i;
+            x[i] = ((double)(j % MC_STRAT_K) + x[i]) * (1.0 / MC_STRAT_K);
+            y[i] = ((double)(j / MC_STRAT_K) + y[i]) * (1.0 / MC_STRAT_K);
+        }
+        break;
+    }
+    case MC_SAMPLER_ANTI:
+        xr_simd_fill01(r, x, XR_BLOCK);
+        xr_simd_fill01(r, y, XR_BLOCK);
+        for (size_t i = 1; i < XR_BLOCK; i += 2) {
+            x[i] = 1.0 - x[i - 1];
+            y[i] = 1.0 - y[i - 1];
+        }
+        break;
+    case MC_SAMPLER_SOBOL: {
+        // 1) puntos sin aleatorizar por código Gray (cadena de xor, escalar)
+        // 2) Owen + conversión a double sobre el bloque (vectorizable)
+        _Alignas(64) uint32_t a0[XR_BLOCK], a1[XR_BLOCK];
+        uint64_t hi = base >> 32;   // base múltiplo de XR_BLOCK: no cruza tramo
+        uint32_t s0 = (uint32_t)mc_dim_seed(seed, 0, hi);
+        uint32_t s1 = (uint32_t)mc_dim_seed(seed, 1, hi);
+        uint32_t k = (uint32_t)base, g = k ^ (k >> 1);
+        uint32_t v0 = mc_reverse32(g), v1 = mc_sobol2(g);
+        for (size_t i = 0; i < XR_BLOCK; ++i) {
+            a0[i] = v0; a1[i] = v1;
+            unsigned j = (unsigned)__builtin_ctz(++k | 0x80000000u);  // bit que cambia en Gray
+            v0 ^= 0x80000000u >> j;
+            v1 ^= mc_sobol2_v[j];
+        }
+        for (size_t i = 0; i < XR_BLOCK; ++i) {
+            x[i] = mc_owen2(a0[i], s0) * MC_U32_TO_01;
+            y[i] = mc_owen2(a1[i], s1) * MC_U32_TO_01;
+        }
+        break;
+    }
+    case MC_SAMPLER_HALTON: {
+        _Alignas(64) uint32_t k[XR_BLOCK];
+        uint64_t hi = base >> 32;
+        uint32_t s0 = (uint32_t)mc_dim_seed(seed, 0, hi);
+        uint32_t s1 = (uint32_t)mc_dim_seed(seed, 1, hi);
+        for (size_t i = 0; i < XR_BLOCK; ++i) {
+            k[i] = (uint32_t)(base + i);
+            x[i] = mc_owen2(mc_reverse32(k[i]), s0) * MC_U32_TO_01;
+        }
+        mc_halton3_owen(k, s1, y, XR_BLOCK);
+        break;
+    }
+    default:
+        xr_simd_fill01(r, x, XR_BLOCK);
+        xr_simd_fill01(r, y, XR_BLOCK);
+    }
+}
+
+// ---- sub-bloques: igual que mc_kernels.h, con los puntos del muestreador ----
+static inline uint64_t mc_dart_sub_s(xr_simd_t *r, size_t lo, size_t hi,
+                                     int s, uint64_t seed, uint64_t base) {
+    _Alignas(64) double x[XR_BLOCK], y[XR_BLOCK];
+    mc_sampler_points(s, r, seed, base, x, y);
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i)
+        c += (x[i]*x[i] + y[i]*y[i] <= 1.0);
+    return c;
+}
+
+// Buffon con seno polinomial: theta = (pi/2) x, distancia = (D/2) y
+static inline uint64_t mc_buffon_sub_s(xr_simd_t *r, size_t lo, size_t hi,
+                                       double half_L, double half_D,
+                                       int s, uint64_t seed, uint64_t base) {
+    _Alignas(64) double th[XR_BLOCK], y[XR_BLOCK];
+    mc_sampler_points(s, r, seed, base, th, y);
+    uint64_t c = 0;
+    for (size_t i = lo; i < hi; ++i)
+        c += (half_D * y[i] <= half_L * mc_sin_poly(MC_PI_HALF * th[i]));
+    return c;
+}
+
+// MC_STREAM_LOOP pasando además la semilla y el índice del sub-bloque
+#define MC_SAMPLER_LOOP(SUB, ...)                                         \
+    uint64_t acc = 0;                                                     \
+    for (uint64_t blk = a / MC_STREAM_BLOCK; blk * MC_STREAM_BLOCK < b; ++blk) { \
+        xr_simd_t r_;                                                     \
+        xr_simd_seed_block(&r_, seed, blk);                               \
+        uint64_t base = blk * MC_STREAM_BLOCK;                            \
+        for (uint64_t o = 0; o < MC_STREAM_BLOCK && base + o < b; o += XR_BLOCK) { \
+            uint64_t s0 = base + o, s1 = s0 + XR_BLOCK;                   \
+            size_t lo = a <= s0 ? 0 : (a < s1 ? (size_t)(a - s0) : XR_BLOCK); \
+            size_t hi = b >= s1 ? XR_BLOCK : (size_t)(b - s0);            \
+            acc += SUB(&r_, lo, hi < lo ? lo : hi, __VA_ARGS__, seed, s0); \
+        }                                                                 \
+    }                                                                     \
+    return acc
+
+// Aciertos del dardo en las muestras [a,b); con s = iid coincide con
+// mc_dart_count_stream(..., MC_DART_DOUBLE)
+static inline uint64_t mc_dart_count_sampler(int s, uint64_t seed, uint64_t a, uint64_t b) {
+    MC_SAMPLER_LOOP(mc_dart_sub_s, s);
+}
+
+// Cruces de Buffon en las muestras [a,b) (una muestra = una aguja); con s = iid
+// coincide con mc_buffon_count_stream(..., MC_SIN_POLY, ...)
+static inline uint64_t mc_buffon_count_sampler(int s, uint64_t seed, uint64_t a, uint64_t b,
+                                               double L, double D) {
+    MC_SAMPLER_LOOP(mc_buffon_sub_s, 0.5 * L, 0.5 * D, s);
+}
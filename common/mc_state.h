@@ -0,0 +1,182 @@
+// mc_state.h — corridas Monte Carlo reanudables (archivo de estado + checkpoints)
+//
+// Con el flujo reproducible (rng_stream.h) la muestra i depende solo de
+// (semilla, i): lo ya contado es un prefijo [0, pos) del flujo y para
+// seguir basta con guardar pos y los acumulados. Una corrida posterior
+// cuenta [pos, N) sin solaparse con lo anterior; el resultado final es
+// idéntico bit a bit al de una sola corrida con el mismo N total.
+//
+// HPC_MC_STATE=<archivo> activa el modo:
+//   - si el archivo existe se carga y se continúa desde pos; N es el NUEVO
+//     total de muestras del flujo (si pos >= N no queda nada que hacer)
+//   - con HPC_MC_TARGET se sigue hasta el error objetivo (N = presupuesto
+//     total, igual que en mc_adaptive.h)
+//   - cada HPC_MC_CHECKPOINT segundos (defecto MC_STATE_INTERVAL) y al final
+//     se reescribe el archivo: si se mata la corrida se pierde a lo sumo un
+//     intervalo
+//
+// El trabajo avanza en rondas [pos, pos + ronda) con la ronda ~ pos/4
+// (entre MC_STATE_MIN_ROUND y MC_STATE_MAX_ROUND, alineada a bloques): con
+// objetivo se para con a lo sumo ~25% de muestras de más.
+//
+// Archivo de texto clave=valor (se escribe en <archivo>.tmp + fsync + rename,
+// nunca queda a medias). seed, kind, mode, sampler y ratio identifican el
+// flujo: si no coinciden con la corrida actual se rechaza el archivo.
+//   mc_state 1
+//   kind=dart  seed=...  mode=...  sampler=...  ratio=...
+//   pos=<muestras del flujo>  hits=<aciertos/cruces>  n=<ensayos (agujas)>
+//   pi=...  se=...            (informativo, no se lee)
+//
+// Uso (range igual que en mc_mpi.h: suma aciertos en acc[0] y ensayos en acc[1]):
+//   mc_state_t st;
+//   mc_state_init(&st, MC_EST_DART, seed, mode, samp, 1.0);
+//   if (mc_state_load(path, &st) < 0) return 4;
+//   mc_state_run(&st, N, target, range, &ctx, path, mc_state_interval_from_env());
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "rng_stream.h"
+#include "mc_adaptive.h"
+
+#define MC_STATE_VERSION   1
+#define MC_STATE_INTERVAL  60.0                          // s entre checkpoints
+#define MC_STATE_MIN_ROUND (16u * MC_STREAM_BLOCK)       // = MC_ADAPT_MIN_N
+#define MC_STATE_MAX_ROUND (1024u * MC_STREAM_BLOCK)     // ~16M muestras
+
+typedef void (*mc_state_range_fn)(uint64_t a, uint64_t b, uint64_t acc[2], const void *ctx);
+
+typedef struct {
+    // identidad del flujo
+    uint64_t seed;
+    int kind;           // MC_EST_*
+    int mode;           // HPC_DART / HPC_BUFFON_SIN
+    int samp;           // HPC_MC_SAMPLER
+    double ratio;       // L/D (solo buffon)
+    // avance
+    uint64_t pos;       // [0, pos) del flujo ya contado
+    uint64_t hits, n;   // aciertos/cruces y ensayos (n = pos salvo buffon reject)
+} mc_state_t;
+
+static inline const char *mc_state_path_from_env(void) {
+    const char *e = getenv("HPC_MC_STATE");
+    return e && *e ? e : NULL;
+}
+
+static inline double mc_state_interval_from_env(void) {
+    const char *e = getenv("HPC_MC_CHECKPOINT");
+    if (!e || !*e) return MC_STATE_INTERVAL;
+    double s = strtod(e, NULL);
+    return s > 0.0 ? s : MC_STATE_INTERVAL;
+}
+
+static inline double mc_state_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline void mc_state_init(mc_state_t *st, int kind, uint64_t seed,
+                                 int mode, int samp, double ratio) {
+    memset(st, 0, sizeof *st);
+    st->kind = kind;
+    st->seed = seed;
+    st->mode = mode;
+    st->samp = samp;
+    st->ratio = ratio;
+}
+
+// 0 bien, -1 error de E/S
+static inline int mc_state_save(const char *path, const mc_state_t *st) {
+    char tmp[4096];
+    if (snprintf(tmp, sizeof tmp, "%s.tmp", path) >= (int)sizeof tmp) return -1;
+    FILE *f = fopen(tmp, "w");
+    if (!f) return -1;
+    fprintf(f, "mc_state %d\n", MC_STATE_VERSION);
+    fprintf(f, "kind=%s\n", st->kind == MC_EST_DART ? "dart" : "buffon");
+    fprintf(f, "seed=%llu\n", (unsigned long long)st->seed);
+    fprintf(f, "mode=%d\n", st->mode);
+    fprintf(f, "sampler=%d\n", st->samp);
+    fprintf(f, "ratio=%.17g\n", st->ratio);
+    fprintf(f, "pos=%llu\n", (unsigned long long)st->pos);
+    fprintf(f, "hits=%llu\n", (unsigned long long)st->hits);
+    fprintf(f, "n=%llu\n", (unsigned long long)st->n);
+    fprintf(f, "pi=%.12f\n", mc_pi_estimate(st->kind, st->hits, st->n, st->ratio));
+    fprintf(f, "se=%.3e\n", mc_pi_stderr(st->kind, st->hits, st->n, st->ratio));
+    int bad = fflush(f) != 0 || fsync(fileno(f)) != 0;
+    bad |= fclose(f) != 0;
+    if (bad || rename(tmp, path) != 0) { remove(tmp); return -1; }
+    return 0;
+}
+
+// Carga el avance guardado en st (que ya trae la identidad de esta corrida).
+// 1 cargado, 0 no existe (se empieza de cero), -1 ilegible o de otro flujo.
+static inline int mc_state_load(const char *path, mc_state_t *st) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    char line[256], kind[16] = "";
+    int ver = 0, mode = -1, samp = -1, seen = 0;
+    unsigned long long seed = 0, pos = 0, hits = 0, n = 0;
+    double ratio = 0.0;
+    if (!fgets(line, sizeof line, f) || sscanf(line, "mc_state %d", &ver) != 1 ||
+        ver != MC_STATE_VERSION) { fclose(f); return -1; }
+    while (fgets(line, sizeof line, f)) {
+        seen |= sscanf(line, "kind=%15s", kind) == 1             ? 1 << 0 : 0;
+        seen |= sscanf(line, "seed=%llu", &seed) == 1            ? 1 << 1 : 0;
+        seen |= sscanf(line, "mode=%d", &mode) == 1              ? 1 << 2 : 0;
+        seen |= sscanf(line, "sampler=%d", &samp) == 1           ? 1 << 3 : 0;
+        seen |= sscanf(line, "ratio=%lf", &ratio) == 1           ? 1 << 4 : 0;
+        seen |= sscanf(line, "pos=%llu", &pos) == 1              ? 1 << 5 : 0;
+        seen |= sscanf(line, "hits=%llu", &hits) == 1            ? 1 << 6 : 0;
+        seen |= sscanf(line, "n=%llu", &n) == 1                  ? 1 << 7 : 0;
+    }
+    fclose(f);
+    if (seen != 0xff) return -1;
+    int kind_id = !strcmp(kind, "dart") ? MC_EST_DART : !strcmp(kind, "buffon") ? MC_EST_BUFFON : -1;
+    if (kind_id != st->kind || seed != st->seed || mode != st->mode ||
+        samp != st->samp || ratio != st->ratio) return -1;
+    if (hits > n || n > pos) return -1;
+    st->pos = pos;
+    st->hits = hits;
+    st->n = n;
+    return 1;
+}
+
+// Cuenta [st->pos, N) (o hasta target) en rondas, con checkpoint cada
+// `interval` segundos y al final. 0 bien, -1 si falló alguna escritura.
+static inline int mc_state_run(mc_state_t *st, uint64_t N, double target,
+                               mc_state_range_fn range, const void *ctx,
+                               const char *path, double interval) {
+    int err = 0;
+    double last = mc_state_now();
+    while (st->pos < N) {
+        if (target > 0.0 && st->n >= MC_ADAPT_MIN_N && st->hits <= st->n &&
+            mc_pi_stderr(st->kind, st->hits, st->n, st->ratio) <= target) break;
+        uint64_t r = st->pos / 4;
+        r = r < MC_STATE_MIN_ROUND ? MC_STATE_MIN_ROUND : r > MC_STATE_MAX_ROUND ? MC_STATE_MAX_ROUND : r;
+        r -= r % MC_STREAM_BLOCK;
+        uint64_t b = N - st->pos > r ? st->pos + r : N;
+        uint64_t acc[2] = {0, 0};
+        range(st->pos, b, acc, ctx);
+        st->hits += acc[0];
+        st->n += acc[1];
+        st->pos = b;
+        double t = mc_state_now();
+        if (path && t - last >= interval) {
+            err |= mc_state_save(path, st);
+            last = t;
+        }
+    }
+    if (path) err |= mc_state_save(path, st);
+    return err;
+}
+
+// Columna extra de Reto2 con HPC_MC_STATE: ",resumed=<pos al empezar>"
+static inline void mc_state_report(FILE *f, const mc_state_t *st, uint64_t pos0, double target) {
+    fprintf(f, ",resumed=%llu", (unsigned long long)pos0);
+    if (target > 0.0) mc_pi_report(f, st->kind, st->hits, st->n, target, st->ratio);
+}
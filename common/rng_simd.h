@@ -0,0 +1,125 @@
+// rng_simd.h — generador xoshiro256+ de 8 carriles para llenar bloques de uniformes
+//
+// El xorshift64* escalar produce un valor por iteración y cada valor depende
+// del anterior: la cadena de dependencias limita el ritmo. Aquí hay 8
+// generadores independientes con el estado en estructura-de-arreglos
+// (s0[8], s1[8], s2[8], s3[8]); un paso actualiza los 8 carriles a la vez con
+// vectores de GCC (-O3 -march=native: 1 registro AVX-512 o 2 AVX2 por palabra
+// de estado). Solo shifts, xor, sumas y rotaciones.
+//
+// Conversión a [0,1) sin multiplicación ni conversión entero->flotante:
+//   double  exponente de 1.0 + 52 bits altos de mantisa  ->  [1,2) - 1.0
+//   float   igual con 23 bits; dos floats por valor de 64 bits (mitad alta y baja)
+// Se usan los bits altos de cada mitad: los bits bajos de xoshiro256+ son los
+// débiles.
+//
+// Uso:
+//   xr_simd_t R;                       // alineado a 64B (en pila o estático)
+//   xr_simd_seed(&R, semilla);         // carriles distintos vía splitmix64
+//   double x[XR_BLOCK];
+//   xr_simd_fill01(&R, x, XR_BLOCK);   // n múltiplo de XR_LANES (u 2*XR_LANES en float)
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define XR_LANES 8
+#define XR_BLOCK 512          // muestras por bloque en los kernels (cabe en L1)
+
+typedef struct {
+    _Alignas(64) uint64_t s0[XR_LANES];
+    _Alignas(64) uint64_t s1[XR_LANES];
+    _Alignas(64) uint64_t s2[XR_LANES];
+    _Alignas(64) uint64_t s3[XR_LANES];
+} xr_simd_t;
+
+static inline uint64_t xr_splitmix64(uint64_t *z) {
+    uint64_t x = (*z += 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Semillas de los 32 words de estado tomadas de una sola secuencia splitmix64:
+// carriles distintos entre sí y nunca con estado todo ceros.
+static inline void xr_simd_seed(xr_simd_t *r, uint64_t seed) {
+    uint64_t z = seed;
+    for (int l = 0; l < XR_LANES; ++l) {
+        r->s0[l] = xr_splitmix64(&z);
+        r->s1[l] = xr_splitmix64(&z);
+        r->s2[l] = xr_splitmix64(&z);
+        r->s3[l] = xr_splitmix64(&z);
+    }
+}
+
+// Vectores de XR_LANES elementos (extensión de GCC/Clang): un paso de los 8
+// carriles es una sola secuencia de instrucciones SIMD (1 zmm en AVX-512, 2 ymm
+// en AVX2). Un bucle de 8 iteraciones sobre arreglos no basta: GCC lo
+// desenrolla a escalares y no lo vectoriza.
+typedef uint64_t xr_u64v __attribute__((vector_size(8 * XR_LANES)));
+typedef double   xr_f64v __attribute__((vector_size(8 * XR_LANES)));
+typedef uint32_t xr_u32v __attribute__((vector_size(4 * XR_LANES)));
+typedef float    xr_f32v __attribute__((vector_size(4 * XR_LANES)));
+
+#define XR_LOAD(r)                                                \
+    xr_u64v s0, s1, s2, s3;                                       \
+    memcpy(&s0, (r)->s0, sizeof s0); memcpy(&s1, (r)->s1, sizeof s1); \
+    memcpy(&s2, (r)->s2, sizeof s2); memcpy(&s3, (r)->s3, sizeof s3)
+
+#define XR_STORE(r)                                               \
+    memcpy((r)->s0, &s0, sizeof s0); memcpy((r)->s1, &s1, sizeof s1); \
+    memcpy((r)->s2, &s2, sizeof s2); memcpy((r)->s3, &s3, sizeof s3)
+
+// Un paso xoshiro256+ de los 8 carriles; deja la salida en u
+#define XR_STEP(u)                                                \
+    do {                                                          \
+        u = s0 + s3;                                              \
+        xr_u64v t_ = s1 << 17;                                    \
+        s2 ^= s0; s3 ^= s1;                                       \
+        s1 ^= s2; s0 ^= s3;                                       \
+        s2 ^= t_; s3 = (s3 << 45) | (s3 >> 19);                   \
+    } while (0)
+
+// n valores de 64 bits (n múltiplo de XR_LANES)
+static inline void xr_simd_fill_u64(xr_simd_t *r, uint64_t * __restrict out, size_t n) {
+    XR_LOAD(r);
+    for (size_t i = 0; i < n; i += XR_LANES) {
+        xr_u64v u;
+        XR_STEP(u);
+        memcpy(out + i, &u, sizeof u);
+    }
+    XR_STORE(r);
+}
+
+// n doubles en [0,1) (n múltiplo de XR_LANES)
+static inline void xr_simd_fill01(xr_simd_t *r, double * __restrict out, size_t n) {
+    XR_LOAD(r);
+    for (size_t i = 0; i < n; i += XR_LANES) {
+        xr_u64v u;
+        XR_STEP(u);
+        u = (u >> 12) | 0x3FF0000000000000ULL;   // [1,2)
+        xr_f64v d;
+        memcpy(&d, &u, sizeof d);
+        d -= 1.0;
+        memcpy(out + i, &d, sizeof d);
+    }
+    XR_STORE(r);
+}
+
+// n floats en [0,1) (n múltiplo de 2*XR_LANES): dos por valor de 64 bits
+static inline void xr_simd_fill01f(xr_simd_t *r, float * __restrict out, size_t n) {
+    XR_LOAD(r);
+    for (size_t i = 0; i < n; i += 2 * XR_LANES) {
+        xr_u64v u;
+        XR_STEP(u);
+        xr_u32v hi = __builtin_convertvector(u >> 41, xr_u32v)                | 0x3F800000u;
+        xr_u32v lo = (__builtin_convertvector(u >> 9, xr_u32v) & 0x7FFFFFu) | 0x3F800000u;
+        xr_f32v a, b;
+        memcpy(&a, &hi, sizeof a); memcpy(&b, &lo, sizeof b);
+        a -= 1.0f; b -= 1.0f;
+        memcpy(out + i,            &a, sizeof a);
+        memcpy(out + i + XR_LANES, &b, sizeof b);
+    }
+    XR_STORE(r);
+}
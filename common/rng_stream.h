@@ -0,0 +1,66 @@
+// rng_stream.h — flujos aleatorios reproducibles basados en contador (Philox4x32-10)
+//
+// Las muestras se agrupan en bloques fijos de MC_STREAM_BLOCK. El estado del
+// generador de 8 carriles (rng_simd.h) de cada bloque se deriva SOLO de
+// (semilla, índice de bloque) con Philox4x32-10, un hash con contador sin estado:
+// la muestra i recibe siempre los mismos números, sin importar cuántos hilos o
+// procesos haya ni cómo se reparta el rango. Una corrida paralela se puede
+// validar bit a bit contra la serial.
+//
+// Derivar un bloque cuesta 16 llamadas a Philox (32 palabras de estado), poco
+// frente a las 2*MC_STREAM_BLOCK/8 iteraciones del generador que produce.
+//
+// Reparto: mc_stream_split corta [0,N) en tramos alineados a bloques; los
+// kernels *_stream de mc_kernels.h aceptan cualquier [a,b) (si a no cae en
+// frontera de bloque se generan y descartan las muestras previas del bloque).
+
+#pragma once
+#include <stdint.h>
+#include "rng_simd.h"
+
+#define MC_STREAM_BLOCK 16384u   // muestras por bloque (múltiplo de XR_BLOCK)
+
+// ---- Philox4x32-10 (Salmon et al., SC'11) ----
+static inline void philox4x32_10(uint32_t c[4], const uint32_t key[2]) {
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < 10; ++r) {
+        uint64_t p0 = (uint64_t)0xD2511F53u * c[0];
+        uint64_t p1 = (uint64_t)0xCD9E8D57u * c[2];
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = (uint32_t)p1;
+        c[3] = (uint32_t)p0;
+        c[0] = n0;
+        c[2] = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+}
+
+// Estado del bloque blk para la semilla seed (carriles independientes entre sí)
+static inline void xr_simd_seed_block(xr_simd_t *r, uint64_t seed, uint64_t blk) {
+    const uint32_t key[2] = { (uint32_t)seed, (uint32_t)(seed >> 32) };
+    uint64_t w[4 * XR_LANES];
+    for (int i = 0; i < 2 * XR_LANES; ++i) {
+        uint32_t c[4] = { (uint32_t)blk, (uint32_t)(blk >> 32), (uint32_t)i, 0x5EEDu };
+        philox4x32_10(c, key);
+        w[2*i]     = (uint64_t)c[0] | ((uint64_t)c[1] << 32);
+        w[2*i + 1] = (uint64_t)c[2] | ((uint64_t)c[3] << 32);
+    }
+    for (int l = 0; l < XR_LANES; ++l) {
+        r->s0[l] = w[4*l];     r->s1[l] = w[4*l + 1];
+        r->s2[l] = w[4*l + 2]; r->s3[l] = w[4*l + 3];
+        if (!(r->s0[l] | r->s1[l] | r->s2[l] | r->s3[l])) r->s0[l] = 1;   // xoshiro no admite estado 0
+    }
+}
+
+// Tramo [*a,*b) del trabajador p de parts, alineado a bloques
+static inline void mc_stream_split(uint64_t n, uint64_t parts, uint64_t p,
+                                   uint64_t *a, uint64_t *b) {
+    uint64_t nb = (n + MC_STREAM_BLOCK - 1) / MC_STREAM_BLOCK;
+    uint64_t chunk = nb / parts, rem = nb % parts;
+    uint64_t ba = p * chunk + (p < rem ? p : rem);
+    uint64_t bb = ba + chunk + (p < rem ? 1 : 0);
+    *a = ba * MC_STREAM_BLOCK < n ? ba * MC_STREAM_BLOCK : n;
+    *b = bb * MC_STREAM_BLOCK < n ? bb * MC_STREAM_BLOCK : n;
+}
@@ -16,6 +16,11 @@
 //
 // Salida en archivo (append), una línea por corrida:
 //   N=<N> P=<P> <segundos>
+//   (con HPC_AFFINITY=<política> se añade " aff=<política>:<cpus>")
+//   (con HPC_TLB=1 se añade " pages=<tipo> huge_kb=<kB> dtlb_misses=<n>")
+//
+// A, B y C salen de una sola arena compartida (MAP_SHARED) con huge pages
+// (ver ../common/arena.h); HPC_HUGEPAGES=0 vuelve a páginas de 4KB.
 
 #define _POSIX_C_SOURCE 199309L
 #define _GNU_SOURCE
@@ -29,6 +34,8 @@
 #include <sys/wait.h>   // waitpid
 #include <unistd.h>     // fork, _exit
 #include <string.h>
+#include "../common/arena.h"
+#include "../common/affinity.h"
 
 // -------- Utilidades básicas --------
 static int parse_positive_int(const char *s, int *out) {
@@ -41,15 +48,9 @@ static int parse_positive_int(const char *s, int *out) {
     return 1;
 }
 
-static void* shm_alloc(size_t bytes, int zero) {
-    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
-                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
-    if (p == MAP_FAILED) return NULL;
-    if (zero) memset(p, 0, bytes);
-    return p;
-}
-static void shm_free(void *p, size_t bytes) {
-    if (p && p != MAP_FAILED) munmap(p, bytes);
+// Matriz dentro de la arena compartida (ya en cero: región recién mapeada)
+static int32_t* shm_alloc_matrix(arena_t *ar, int n) {
+    return (int32_t*)arena_alloc(ar, (size_t)n * (size_t)n * sizeof(int32_t));
 }
 
 // -------- Aleatorios 32-bit (acotados a 16-bit para evitar desbordes grandes) --------
@@ -85,7 +86,8 @@ static void matmul_block(const int32_t *A, const int32_t *B, int32_t *C,
 }
 
 // -------- Multiplicación paralela por procesos (SIN transponer B) --------
-static int matmul_processes(const int32_t *A, const int32_t *B, int32_t *C, int n, int P)
+static int matmul_processes(const int32_t *A, const int32_t *B, int32_t *C, int n, int P,
+                            const affinity_t *aff)
 {
     if (P < 1) P = 1;
     if (P > n) P = n; // no más procesos que filas
@@ -109,7 +111,8 @@ static int matmul_processes(const int32_t *A, const int32_t *B, int32_t *C, int
             return 0;
         }
         if (pid == 0) {
-            // Hijo: calcula su bloque y sale
+            // Hijo: se fija a su CPU (si hay política), calcula su bloque y sale
+            affinity_pin_process(aff, p);
             matmul_block(A, B, C, n, start, end);
             _exit(0);
         }
@@ -147,14 +150,26 @@ int main(int argc, char **argv) {
         outfile = argv[4];
     }
 
+    affinity_t aff;
+    affinity_from_env(&aff, P);
+
+    // Contador de dTLB antes del fork (inherit cuenta a los hijos)
+    tlb_counter_t tlb = { -1 };
+    if (tlb_report_enabled()) tlb_counter_open(&tlb);
+
     size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
 
-    // A, B y C en memoria compartida
-    int32_t *A = (int32_t*)shm_alloc(bytes, 0);
-    int32_t *B = (int32_t*)shm_alloc(bytes, 0);
-    int32_t *C = (int32_t*)shm_alloc(bytes, 1); // en cero
+    // A, B y C en una sola región compartida, prefault con P hilos
+    arena_t ar;
+    if (!arena_init(&ar, 3 * arena_round_up(bytes, ARENA_ALIGN), ARENA_SHARED)) { affinity_release(&aff); return 6; }
+    arena_prefault(&ar, P);
+
+    int32_t *A = shm_alloc_matrix(&ar, N);
+    int32_t *B = shm_alloc_matrix(&ar, N);
+    int32_t *C = shm_alloc_matrix(&ar, N);
     if (!A || !B || !C) {
-        shm_free(A, bytes); shm_free(B, bytes); shm_free(C, bytes);
+        arena_destroy(&ar);
+        affinity_release(&aff);
         return 6;
     }
 
@@ -164,11 +179,15 @@ int main(int argc, char **argv) {
     // Cronometrar SOLO la multiplicación paralela por procesos (B original)
     struct timespec t0, t1;
     clock_gettime(CLOCK_MONOTONIC, &t0);
-    int ok = matmul_processes(A, B, C, N, P);
+    tlb_counter_start(&tlb);
+    int ok = matmul_processes(A, B, C, N, P, &aff);
+    tlb_counter_stop(&tlb);
     clock_gettime(CLOCK_MONOTONIC, &t1);
 
     if (!ok) {
-        shm_free(A, bytes); shm_free(B, bytes); shm_free(C, bytes);
+        arena_destroy(&ar);
+        affinity_release(&aff);
+        tlb_counter_close(&tlb);
         return 8;
     }
 
@@ -178,12 +197,22 @@ int main(int argc, char **argv) {
     // Registrar tiempo en archivo (append): "N=<N> P=<P> <segundos>"
     FILE *f = fopen(outfile, "a");
     if (!f) {
-        shm_free(A, bytes); shm_free(B, bytes); shm_free(C, bytes);
+        arena_destroy(&ar);
+        affinity_release(&aff);
+        tlb_counter_close(&tlb);
         return 7;
     }
-    fprintf(f, "N=%d P=%d %.6f\n", N, P, elapsed);
+    fprintf(f, "N=%d P=%d %.6f", N, P, elapsed);
+    if (aff.enabled) {
+        char buf[512];
+        fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+    }
+    if (tlb_report_enabled()) arena_report(f, &ar, &tlb);
+    fprintf(f, "\n");
     fclose(f);
 
-    shm_free(A, bytes); shm_free(B, bytes); shm_free(C, bytes);
+    arena_destroy(&ar);
+    affinity_release(&aff);
+    tlb_counter_close(&tlb);
     return 0;
 }
@@ -3,14 +3,19 @@
 // Ejecutar (con semilla opcional):
 //   ./mm_seq_time_log 500 12345 tiempos.txt
 //   ./mm_seq_time_log 500 tiempos.txt        // sin semilla
+//
+// A, B y C salen de una sola arena con huge pages (ver ../common/arena.h);
+// HPC_HUGEPAGES=0 vuelve a páginas de 4KB y HPC_TLB=1 añade
+// " pages=<tipo> huge_kb=<kB> dtlb_misses=<n>" a la línea de salida.
 
-#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <stdint.h>
 #include <time.h>
 #include <errno.h>
 #include <limits.h>
 #include <stdio.h>   // solo para E/S a archivo (no stdout/stderr)
+#include "../common/arena.h"
 
 // -------------------- Random 32-bit --------------------
 static int32_t random_int32(void) {
@@ -29,14 +34,10 @@ static void fill_random_int32(int32_t *M, int n) {
 }
 
 // -------------------- Matrices --------------------
-static int32_t* alloc_matrix(int n) {
+// Salen de la arena; la región recién mapeada ya está en cero.
+static int32_t* alloc_matrix(arena_t *ar, int n) {
     size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)malloc(nn * sizeof(int32_t));
-}
-
-static int32_t* alloc_zero_matrix(int n) {
-    size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)calloc(nn, sizeof(int32_t));
+    return (int32_t*)arena_alloc(ar, nn * sizeof(int32_t));
 }
 
 // -------------------- Multiplicación O(n^3) --------------------
@@ -87,11 +88,21 @@ int main(int argc, char **argv) {
         outfile = argv[3];
     }
 
-    int32_t *A = alloc_matrix(N);
-    int32_t *B = alloc_matrix(N);
-    int32_t *C = alloc_zero_matrix(N);
+    tlb_counter_t tlb = { -1 };
+    if (tlb_report_enabled()) tlb_counter_open(&tlb);
+
+    // Una sola región para A, B y C; el prefault usa todos los núcleos
+    // aunque la multiplicación sea secuencial (queda fuera del tiempo medido)
+    size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
+    arena_t ar;
+    if (!arena_init(&ar, 3 * arena_round_up(bytes, ARENA_ALIGN), 0)) return 6;
+    arena_prefault(&ar, (int)sysconf(_SC_NPROCESSORS_ONLN));
+
+    int32_t *A = alloc_matrix(&ar, N);
+    int32_t *B = alloc_matrix(&ar, N);
+    int32_t *C = alloc_matrix(&ar, N);
     if (!A || !B || !C) {
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
         return 6;
     }
 
@@ -100,7 +111,9 @@ int main(int argc, char **argv) {
 
     struct timespec t0, t1;
     clock_gettime(CLOCK_MONOTONIC, &t0);
+    tlb_counter_start(&tlb);
     matmul_seq(A, B, C, N);
+    tlb_counter_stop(&tlb);
     clock_gettime(CLOCK_MONOTONIC, &t1);
 
     // Tiempo en segundos (double)
@@ -112,14 +125,18 @@ int main(int argc, char **argv) {
     if (f) {
         // una línea por corrida, etiquetada con N
         // Ejemplo: "N=500 0.023451"
-        fprintf(f, "N=%d %.6f\n", N, elapsed);
+        fprintf(f, "N=%d %.6f", N, elapsed);
+        if (tlb_report_enabled()) arena_report(f, &ar, &tlb);
+        fprintf(f, "\n");
         fclose(f);
     } else {
         // Si no se pudo abrir, retornamos error diferente
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
+        tlb_counter_close(&tlb);
         return 7;
     }
 
-    free(A); free(B); free(C);
+    arena_destroy(&ar);
+    tlb_counter_close(&tlb);
     return 0;
 }
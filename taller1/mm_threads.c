@@ -11,8 +11,13 @@
 //   4) outfile        (ruta del archivo de salida, obligatorio si hay seed; si no hay seed, es el 3er arg)
 //
 // Salida a archivo (append), una línea por corrida: "N=<N> T=<T> <segundos>"
+// (con HPC_AFFINITY=<política> se añade " aff=<política>:<cpus>")
+// (con HPC_TLB=1 se añade " pages=<tipo> huge_kb=<kB> dtlb_misses=<n>")
+//
+// A, B y C salen de una sola arena con huge pages (ver ../common/arena.h);
+// HPC_HUGEPAGES=0 vuelve a páginas de 4KB para comparar.
 
-#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <stdint.h>
 #include <time.h>
@@ -22,6 +27,8 @@
 //sudo apt update
 //sudo apt install build-essential
 #include <pthread.h>
+#include "../common/arena.h"
+#include "../common/affinity.h"
 
 typedef struct {
     const int32_t *A;
@@ -30,6 +37,7 @@ typedef struct {
     int n;
     int t_id;
     int t_count;
+    const affinity_t *aff;   // afinidad opcional (HPC_AFFINITY)
 } worker_args_t;
 
 // -------------------- Utilidades --------------------
@@ -43,14 +51,10 @@ static int parse_positive_int(const char *s, int *out) {
     return 1;
 }
 
-static int32_t* alloc_matrix(int n) {
-    size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)malloc(nn * sizeof(int32_t));
-}
-
-static int32_t* alloc_zero_matrix(int n) {
+// Las matrices salen de la arena; la región recién mapeada ya está en cero.
+static int32_t* alloc_matrix(arena_t *ar, int n) {
     size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)calloc(nn, sizeof(int32_t));
+    return (int32_t*)arena_alloc(ar, nn * sizeof(int32_t));
 }
 
 static int32_t random_int32(void) {
@@ -77,6 +81,7 @@ static void* worker_run(void *arg) {
     int n = w->n;
     int tid = w->t_id;
     int tcount = w->t_count;
+    affinity_pin_thread(w->aff, tid);
 
     // Particiona por filas de C: cada hilo procesa un bloque contiguo.
     int rows_per_thread = n / tcount;
@@ -100,7 +105,8 @@ static void* worker_run(void *arg) {
 }
 
 // -------------------- Multiplicación paralela con T hilos --------------------
-static void matmul_parallel(const int32_t *A, const int32_t *B, int32_t *C, int n, int T) {
+static void matmul_parallel(const int32_t *A, const int32_t *B, int32_t *C, int n, int T,
+                            const affinity_t *aff) {
     if (T < 1) T = 1;
     if (T > n) T = n; // no más hilos que filas
 
@@ -114,6 +120,7 @@ static void matmul_parallel(const int32_t *A, const int32_t *B, int32_t *C, int
         args[t].n = n;
         args[t].t_id = t;
         args[t].t_count = T;
+        args[t].aff = aff;
         pthread_create(&threads[t], NULL, worker_run, &args[t]);
     }
     for (int t = 0; t < T; ++t) {
@@ -153,11 +160,25 @@ int main(int argc, char **argv) {
         outfile = argv[4];
     }
 
-    int32_t *A = alloc_matrix(N);
-    int32_t *B = alloc_matrix(N);
-    int32_t *C = alloc_zero_matrix(N);
+    affinity_t aff;
+    affinity_from_env(&aff, T);
+
+    // Contador de dTLB antes de crear hilos (inherit los incluye)
+    tlb_counter_t tlb = { -1 };
+    if (tlb_report_enabled()) tlb_counter_open(&tlb);
+
+    // Una sola región para A, B y C, prefault con T hilos fuera del tiempo medido
+    size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
+    arena_t ar;
+    if (!arena_init(&ar, 3 * arena_round_up(bytes, ARENA_ALIGN), 0)) { affinity_release(&aff); return 6; }
+    arena_prefault(&ar, T);
+
+    int32_t *A = alloc_matrix(&ar, N);
+    int32_t *B = alloc_matrix(&ar, N);
+    int32_t *C = alloc_matrix(&ar, N);
     if (!A || !B || !C) {
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
+        affinity_release(&aff);
         return 6;
     }
 
@@ -167,7 +188,9 @@ int main(int argc, char **argv) {
     // Cronometrar SOLO la multiplicación paralela (con B original)
     struct timespec t0, t1;
     clock_gettime(CLOCK_MONOTONIC, &t0);
-    matmul_parallel(A, B, C, N, T);
+    tlb_counter_start(&tlb);
+    matmul_parallel(A, B, C, N, T, &aff);
+    tlb_counter_stop(&tlb);
     clock_gettime(CLOCK_MONOTONIC, &t1);
 
     double elapsed = (t1.tv_sec - t0.tv_sec) +
@@ -176,12 +199,22 @@ int main(int argc, char **argv) {
     // Escribir en archivo en modo append: "N=<N> T=<T> <segundos>"
     FILE *f = fopen(outfile, "a");
     if (!f) {
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
+        affinity_release(&aff);
+        tlb_counter_close(&tlb);
         return 7;
     }
-    fprintf(f, "N=%d T=%d %.6f\n", N, T, elapsed);
+    fprintf(f, "N=%d T=%d %.6f", N, T, elapsed);
+    if (aff.enabled) {
+        char buf[512];
+        fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+    }
+    if (tlb_report_enabled()) arena_report(f, &ar, &tlb);
+    fprintf(f, "\n");
     fclose(f);
 
-    free(A); free(B); free(C);
+    arena_destroy(&ar);
+    affinity_release(&aff);
+    tlb_counter_close(&tlb);
     return 0;
 }
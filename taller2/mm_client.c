@@ -0,0 +1,96 @@
+// mm_client.c — cliente de línea de comandos de mm_server
+//
+// Compilar:
+//   gcc -O3 -std=c11 -march=native mm_client.c -o mm_client
+// Args:
+//   1) N        (tamaño de la matriz cuadrada, obligatorio)
+//   2) outfile  (ruta del archivo de salida, obligatorio)
+//   3) [seed]   (opcional; si no se da, usa time(NULL))
+//   4) [socket] (opcional; por defecto /tmp/mm_service.sock)
+//
+// Salida (append), una línea por llamada:
+//   N=<N> srv=<cómputo s> queue=<cola s> rtt=<ida y vuelta s> check=<ok|FAIL>
+// check compara 64 entradas de C (elegidas al azar) contra el producto directo.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include "mm_service.h"
+
+static int parse_positive_int(const char *s, int *out) {
+    errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
+    if (errno || e == s || *e != '\0' || v <= 0 || v > INT_MAX) return 0;
+    *out = (int)v; return 1;
+}
+
+static void fill_random_int32(int32_t *M, int n) {
+    size_t nn = (size_t)n * (size_t)n;
+    for (size_t i = 0; i < nn; ++i)
+        M[i] = (int32_t)((rand() & 0xFFFF) - 32768); // [-32768, 32767]
+}
+
+// Verifica algunas entradas de C contra la definición (recorte a 32 bits incluido)
+static int check_sample(const mm_job_t *j, int samples) {
+    int n = j->n;
+    for (int s = 0; s < samples; ++s) {
+        int i = rand() % n, c = rand() % n;
+        int64_t acc = 0;
+        for (int k = 0; k < n; ++k)
+            acc += (int64_t)j->A[(size_t)i*n + k] * (int64_t)j->B[(size_t)k*n + c];
+        if (j->C[(size_t)i*n + c] != (int32_t)acc) return 0;
+    }
+    return 1;
+}
+
+static inline double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) return 2;
+
+    int N = 0;
+    if (!parse_positive_int(argv[1], &N)) return 3;
+    const char *outfile = argv[2];
+
+    if (argc >= 4) {
+        int seed = 0;
+        if (!parse_positive_int(argv[3], &seed)) return 4;
+        srand((unsigned)seed);
+    } else {
+        srand((unsigned)time(NULL));
+    }
+    const char *path = (argc >= 5) ? argv[4] : MM_SOCK_DEFAULT;
+
+    mm_job_t job;
+    if (!mm_job_create(&job, N)) return 6;
+    fill_random_int32(job.A, N);
+    fill_random_int32(job.B, N);
+
+    int sock = mm_connect(path);
+    if (sock < 0) { mm_job_destroy(&job); return 8; }
+
+    mm_resp_t resp;
+    double t0 = now_sec();
+    int ok = mm_job_run(sock, &job, 1, 0, &resp);
+    double t1 = now_sec();
+    close(sock);
+
+    if (!ok || resp.status != MM_OK) { mm_job_destroy(&job); return 9; }
+
+    int good = check_sample(&job, 64);
+
+    FILE *f = fopen(outfile, "a");
+    if (!f) { mm_job_destroy(&job); return 7; }
+    fprintf(f, "N=%d srv=%.6f queue=%.6f rtt=%.6f check=%s\n",
+            N, resp.compute_s, resp.queue_s, t1 - t0, good ? "ok" : "FAIL");
+    fclose(f);
+
+    mm_job_destroy(&job);
+    return good ? 0 : 10;
+}
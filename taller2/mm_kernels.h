@@ -0,0 +1,141 @@
+// mm_kernels.h — kernels OpenMP con B transpuesta (Bt)
+//
+// Compartidos por mm_omp_opt_mem.c y el servicio persistente (mm_server.c).
+// Incluye las variantes con epílogo fusionado (bias / clamp / relu).
+// Todos los punteros deben venir alineados a 64B (arena o memfd con offsets
+// redondeados, ver mm_service.h).
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <omp.h>
+
+// ---- transposición de B a Bt (paralela) ----
+static inline void transpose_omp(const int32_t * __restrict B0,
+                                 int32_t       * __restrict Bt0, int n)
+{
+    // Afirmar alineación para vectorizador (solo si realmente están alineados)
+    const int32_t *B  = __builtin_assume_aligned(B0,  64);
+    int32_t       *Bt = __builtin_assume_aligned(Bt0, 64);
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            Bt[(size_t)j*n + (size_t)i] = B[(size_t)i*n + (size_t)j];
+}
+
+// ---- epílogos fusionados ----
+// Se aplican sobre el acumulador int64 en registro, antes del único store de C,
+// en vez de una segunda pasada n^2 de lectura-modificación-escritura:
+//   bias   C[i][j] += bias[j]            (fila de n elementos)
+//   clamp  satura a [INT32_MIN, INT32_MAX] en vez de recortar a 32 bits
+//   relu   C[i][j] = max(0, C[i][j])
+// Sin clamp el resultado es el mismo que recortar y luego sumar bias en int32
+// (aritmética modular), es decir, idéntico a la pasada separada de siempre.
+typedef struct {
+    const int32_t *bias;   // NULL = sin bias
+    int clamp;
+    int relu;
+} mm_epilogue_t;
+
+static inline int32_t mm_sat32(int64_t v) {
+    return v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : (int32_t)v);
+}
+
+// Un kernel especializado por combinación: las ramas se resuelven en compilación
+#define MM_DEFINE_BT_KERNEL(NAME, BIAS, CLAMP, RELU)                              \
+static inline void NAME(const int32_t * __restrict A0,                            \
+                        const int32_t * __restrict Bt0,                           \
+                        int32_t       * __restrict C0, int n,                     \
+                        const int32_t * __restrict bias)                          \
+{                                                                                 \
+    const int32_t *A  = __builtin_assume_aligned(A0,  64);                        \
+    const int32_t *Bt = __builtin_assume_aligned(Bt0, 64);                        \
+    int32_t       *C  = __builtin_assume_aligned(C0,  64);                        \
+    (void)bias;                                                                   \
+                                                                                  \
+    _Pragma("omp parallel for schedule(static)")                                  \
+    for (int i = 0; i < n; ++i) {                                                 \
+        const int32_t *Ai = &A[(size_t)i*n];                                      \
+        for (int j = 0; j < n; ++j) {                                             \
+            const int32_t *Btj = &Bt[(size_t)j*n];                                \
+            int64_t acc = 0;                                                      \
+            /* innermost vectorizable, recorrido lineal en Ai[] y Btj[] */        \
+            for (int k = 0; k < n; ++k) {                                         \
+                acc += (int64_t)Ai[k] * (int64_t)Btj[k];                          \
+            }                                                                     \
+            if (BIAS) acc += bias[j];                                             \
+            int32_t r = (CLAMP) ? mm_sat32(acc)                                   \
+                                : (int32_t)(uint32_t)(uint64_t)acc; /* recorte */ \
+            if (RELU) r = r < 0 ? 0 : r;                                          \
+            C[(size_t)i*n + (size_t)j] = r;                                       \
+        }                                                                         \
+    }                                                                             \
+}
+
+MM_DEFINE_BT_KERNEL(mm_bt_plain,           0, 0, 0)
+MM_DEFINE_BT_KERNEL(mm_bt_relu,            0, 0, 1)
+MM_DEFINE_BT_KERNEL(mm_bt_clamp,           0, 1, 0)
+MM_DEFINE_BT_KERNEL(mm_bt_clamp_relu,      0, 1, 1)
+MM_DEFINE_BT_KERNEL(mm_bt_bias,            1, 0, 0)
+MM_DEFINE_BT_KERNEL(mm_bt_bias_relu,       1, 0, 1)
+MM_DEFINE_BT_KERNEL(mm_bt_bias_clamp,      1, 1, 0)
+MM_DEFINE_BT_KERNEL(mm_bt_bias_clamp_relu, 1, 1, 1)
+
+// ---- kernel OpenMP usando Bt (accesos contiguos en el bucle interno) ----
+static inline void matmul_omp_with_Bt(const int32_t * __restrict A0,
+                                      const int32_t * __restrict Bt0,
+                                      int32_t       * __restrict C0, int n)
+{
+    mm_bt_plain(A0, Bt0, C0, n, NULL);
+}
+
+// Igual, con epílogo fusionado (ep == NULL equivale a matmul_omp_with_Bt)
+static inline void matmul_omp_with_Bt_ep(const int32_t * __restrict A,
+                                         const int32_t * __restrict Bt,
+                                         int32_t       * __restrict C, int n,
+                                         const mm_epilogue_t *ep)
+{
+    if (!ep) { mm_bt_plain(A, Bt, C, n, NULL); return; }
+    int sel = (ep->bias ? 4 : 0) | (ep->clamp ? 2 : 0) | (ep->relu ? 1 : 0);
+    switch (sel) {
+        case 0: mm_bt_plain          (A, Bt, C, n, ep->bias); break;
+        case 1: mm_bt_relu           (A, Bt, C, n, ep->bias); break;
+        case 2: mm_bt_clamp          (A, Bt, C, n, ep->bias); break;
+        case 3: mm_bt_clamp_relu     (A, Bt, C, n, ep->bias); break;
+        case 4: mm_bt_bias           (A, Bt, C, n, ep->bias); break;
+        case 5: mm_bt_bias_relu      (A, Bt, C, n, ep->bias); break;
+        case 6: mm_bt_bias_clamp     (A, Bt, C, n, ep->bias); break;
+        default: mm_bt_bias_clamp_relu(A, Bt, C, n, ep->bias); break;
+    }
+}
+
+// Pasada separada equivalente (solo para comparar): bias + relu sobre C int32
+static inline void mm_epilogue_pass(int32_t *C, int n, const mm_epilogue_t *ep) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) {
+            int32_t r = C[(size_t)i*n + (size_t)j];
+            if (ep->bias) r = (int32_t)((uint32_t)r + (uint32_t)ep->bias[j]);
+            if (ep->relu) r = r < 0 ? 0 : r;
+            C[(size_t)i*n + (size_t)j] = r;
+        }
+}
+
+// Parsea "none", "bias", "clamp", "relu" o combinaciones con '+' ("bias+clamp+relu").
+// El bias (si se pide) lo pone el llamador. Devuelve 0 si hay un nombre desconocido.
+static inline int mm_epilogue_parse(const char *s, mm_epilogue_t *ep, int *want_bias) {
+    ep->bias = NULL; ep->clamp = 0; ep->relu = 0; *want_bias = 0;
+    while (*s) {
+        size_t len = strcspn(s, "+");
+        if      (len == 4 && strncmp(s, "none",  4) == 0) {}
+        else if (len == 4 && strncmp(s, "bias",  4) == 0) *want_bias = 1;
+        else if (len == 5 && strncmp(s, "clamp", 5) == 0) ep->clamp = 1;
+        else if (len == 4 && strncmp(s, "relu",  4) == 0) ep->relu = 1;
+        else return 0;
+        s += len;
+        if (*s == '+') s++;
+    }
+    return 1;
+}
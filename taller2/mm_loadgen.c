@@ -0,0 +1,149 @@
+// mm_loadgen.c — generador de carga para mm_server (throughput y latencia)
+//
+// C clientes concurrentes, cada uno con su conexión y su memfd (reutilizado
+// entre trabajos, como haría un cliente real), mandan J trabajos en total.
+//
+// Compilar:
+//   gcc -O3 -std=c11 -march=native -pthread mm_loadgen.c -o mm_loadgen
+// Args:
+//   1) N        (tamaño de la matriz, obligatorio)
+//   2) J        (trabajos totales, obligatorio)
+//   3) C        (clientes concurrentes, obligatorio)
+//   4) outfile  (obligatorio)
+//   5) [socket] (opcional; por defecto /tmp/mm_service.sock)
+//   6) [stable] (opcional; 1 = marcar B como estable, el servidor salta el hash de B)
+//
+// Salida (append), una línea por corrida:
+//   N=<N> J=<J> C=<C> wall=<s> thr=<trabajos/s> p50=<ms> p99=<ms> max=<ms> srv=<ms medio de cómputo> bt_hits=<h>
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include "mm_service.h"
+
+static int parse_positive_int(const char *s, int *out) {
+    errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
+    if (errno || e == s || *e != '\0' || v <= 0 || v > INT_MAX) return 0;
+    *out = (int)v; return 1;
+}
+
+static inline double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    int id, n, jobs;
+    const char *path;
+    uint32_t flags;
+    double *lat;        // latencias de este cliente (segundos), solo trabajos OK
+    int nlat;           // cuántas hay en lat
+    double srv_sum;
+    int errors, bt_hits;
+} client_t;
+
+static void* client_run(void *arg) {
+    client_t *c = (client_t*)arg;
+    mm_job_t job;
+    if (!mm_job_create(&job, c->n)) { c->errors = c->jobs; return NULL; }
+
+    unsigned seed = 12345u + (unsigned)c->id;
+    size_t nn = (size_t)c->n * (size_t)c->n;
+    for (size_t i = 0; i < nn; ++i) {
+        job.A[i] = (int32_t)((rand_r(&seed) & 0xFFFF) - 32768);
+        job.B[i] = (int32_t)((rand_r(&seed) & 0xFFFF) - 32768);
+    }
+
+    int sock = mm_connect(c->path);
+    if (sock < 0) { c->errors = c->jobs; mm_job_destroy(&job); return NULL; }
+
+    for (int k = 0; k < c->jobs; ++k) {
+        mm_resp_t r;
+        double t0 = now_sec();
+        int ok = mm_job_run(sock, &job, (uint64_t)k, c->flags, &r);
+        double dt = now_sec() - t0;
+        // un error vuelve rápido: su latencia no entra en p50/p99/max
+        if (!ok || r.status != MM_OK) { c->errors++; continue; }
+        c->lat[c->nlat++] = dt;
+        c->srv_sum += r.compute_s;
+        c->bt_hits += r.bt_hit;
+    }
+    close(sock);
+    mm_job_destroy(&job);
+    return NULL;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) return 2;
+    int N = 0, J = 0, C = 0;
+    if (!parse_positive_int(argv[1], &N)) return 3;
+    if (!parse_positive_int(argv[2], &J)) return 3;
+    if (!parse_positive_int(argv[3], &C)) return 3;
+    const char *outfile = argv[4];
+    const char *path = (argc >= 6) ? argv[5] : MM_SOCK_DEFAULT;
+    uint32_t flags = (argc >= 7 && argv[6][0] == '1') ? MM_F_B_STABLE : 0;
+    if (C > J) C = J;
+
+    double *lat = (double*)calloc((size_t)J, sizeof(double));
+    client_t *cl = (client_t*)calloc((size_t)C, sizeof(client_t));
+    pthread_t *th = (pthread_t*)malloc((size_t)C * sizeof(pthread_t));
+    if (!lat || !cl || !th) { free(lat); free(cl); free(th); return 6; }
+
+    int per = J / C, rem = J % C, off = 0;
+    for (int i = 0; i < C; ++i) {
+        cl[i].id = i; cl[i].n = N; cl[i].path = path; cl[i].flags = flags;
+        cl[i].jobs = per + (i < rem ? 1 : 0);
+        cl[i].lat = lat + off;
+        off += cl[i].jobs;
+    }
+
+    double t0 = now_sec();
+    for (int i = 0; i < C; ++i) pthread_create(&th[i], NULL, client_run, &cl[i]);
+    for (int i = 0; i < C; ++i) pthread_join(th[i], NULL);
+    double wall = now_sec() - t0;
+
+    int errors = 0, bt_hits = 0;
+    double srv = 0.0;
+    for (int i = 0; i < C; ++i) {
+        errors += cl[i].errors; srv += cl[i].srv_sum; bt_hits += cl[i].bt_hits;
+    }
+    int done = J - errors;
+
+    // percentiles solo sobre los trabajos completados: se juntan las latencias
+    // válidas de cada cliente al principio de lat
+    size_t m = 0;
+    for (int i = 0; i < C; ++i) {
+        memmove(lat + m, cl[i].lat, (size_t)cl[i].nlat * sizeof(double));
+        m += (size_t)cl[i].nlat;
+    }
+    double p50 = 0.0, p99 = 0.0, pmax = 0.0;
+    if (m > 0) {
+        qsort(lat, m, sizeof(double), cmp_double);
+        p50 = lat[(size_t)(0.50 * (double)(m - 1))];
+        p99 = lat[(size_t)(0.99 * (double)(m - 1))];
+        pmax = lat[m - 1];
+    }
+
+    FILE *f = fopen(outfile, "a");
+    if (!f) { free(lat); free(cl); free(th); return 7; }
+    fprintf(f, "N=%d J=%d C=%d wall=%.6f thr=%.3f p50=%.3f p99=%.3f max=%.3f srv=%.3f bt_hits=%d",
+            N, J, C, wall, done / wall, p50 * 1e3, p99 * 1e3, pmax * 1e3,
+            done ? srv / done * 1e3 : 0.0, bt_hits);
+    if (errors) fprintf(f, " errors=%d", errors);
+    fprintf(f, "\n");
+    fclose(f);
+
+    free(lat); free(cl); free(th);
+    return errors ? 9 : 0;
+}
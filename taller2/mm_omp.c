@@ -6,7 +6,13 @@
 //
 // Salida (append), una línea por corrida:
 //   N=<N> T=<T> <segundos>
+//   (con HPC_AFFINITY=<política> se añade " aff=<política>:<cpus>")
+//   (con HPC_TLB=1 se añade " pages=<tipo> huge_kb=<kB> dtlb_misses=<n>")
+//
+// A, B y C salen de una sola arena con huge pages (ver ../common/arena.h);
+// HPC_HUGEPAGES=0 vuelve a páginas de 4KB para comparar.
 
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -14,6 +20,8 @@
 #include <errno.h>
 #include <limits.h>
 #include <omp.h>
+#include "../common/arena.h"
+#include "../common/affinity.h"
 
 static int parse_positive_int(const char *s, int *out) {
     errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
@@ -21,13 +29,10 @@ static int parse_positive_int(const char *s, int *out) {
     *out = (int)v; return 1;
 }
 
-static int32_t* alloc_matrix(int n) {
-    size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)malloc(nn * sizeof(int32_t));
-}
-static int32_t* alloc_zero_matrix(int n) {
+// Las matrices salen de la arena; la región recién mapeada ya está en cero.
+static int32_t* alloc_matrix(arena_t *ar, int n) {
     size_t nn = (size_t)n * (size_t)n;
-    return (int32_t*)calloc(nn, sizeof(int32_t));
+    return (int32_t*)arena_alloc(ar, nn * sizeof(int32_t));
 }
 
 static void fill_random_int32(int32_t *M, int n) {
@@ -67,13 +72,32 @@ int main(int argc, char **argv) {
         srand((unsigned)time(NULL));
     }
 
+    // Contador de dTLB antes de crear hilos (inherit los incluye)
+    tlb_counter_t tlb = { -1 };
+    if (tlb_report_enabled()) tlb_counter_open(&tlb);
+
     omp_set_num_threads(T);
 
-    int32_t *A = alloc_matrix(N);
-    int32_t *B = alloc_matrix(N);
-    int32_t *C = alloc_zero_matrix(N);
+    // Afinidad opcional (HPC_AFFINITY): cada hilo del pool OpenMP se fija una vez;
+    // libgomp reutiliza los mismos hilos en las regiones paralelas siguientes
+    affinity_t aff;
+    if (affinity_from_env(&aff, T)) {
+        #pragma omp parallel
+        affinity_pin_thread(&aff, omp_get_thread_num());
+    }
+
+    // Una sola región para A, B y C, prefault paralelo fuera del tiempo medido
+    size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
+    arena_t ar;
+    if (!arena_init(&ar, 3 * arena_round_up(bytes, ARENA_ALIGN), 0)) { affinity_release(&aff); return 6; }
+    arena_prefault(&ar, T);
+
+    int32_t *A = alloc_matrix(&ar, N);
+    int32_t *B = alloc_matrix(&ar, N);
+    int32_t *C = alloc_matrix(&ar, N);
     if (!A || !B || !C) {
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
+        affinity_release(&aff);
         return 6;
     }
 
@@ -82,19 +106,31 @@ int main(int argc, char **argv) {
 
     // Medimos SOLO la multiplicación
     double t0 = omp_get_wtime();
+    tlb_counter_start(&tlb);
     matmul_omp(A, B, C, N);
+    tlb_counter_stop(&tlb);
     double t1 = omp_get_wtime();
     double elapsed = t1 - t0;
 
     // Guardar tiempo en archivo
     FILE *f = fopen(outfile, "a");
     if (!f) {
-        free(A); free(B); free(C);
+        arena_destroy(&ar);
+        affinity_release(&aff);
+        tlb_counter_close(&tlb);
         return 7;
     }
-    fprintf(f, "N=%d T=%d %.6f\n", N, T, elapsed);
+    fprintf(f, "N=%d T=%d %.6f", N, T, elapsed);
+    if (aff.enabled) {
+        char buf[512];
+        fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+    }
+    if (tlb_report_enabled()) arena_report(f, &ar, &tlb);
+    fprintf(f, "\n");
     fclose(f);
 
-    free(A); free(B); free(C);
+    arena_destroy(&ar);
+    affinity_release(&aff);
+    tlb_counter_close(&tlb);
     return 0;
 }
@@ -3,13 +3,26 @@
 //   2) T        (número de hilos OpenMP, obligatorio)
 //   3) outfile  (ruta del archivo de salida, obligatorio)
 //   4) [seed]   (opcional; si no se da, usa time(NULL))
+//   5) [epi]    (opcional; epílogo fusionado: none | bias | clamp | relu, o
+//                combinados con '+', p. ej. bias+clamp+relu)
 //
 // Salida (append), una línea por corrida:
 //   N=<N> T=<T> K=Bt <segundos>
+//   (con HPC_AFFINITY=<política> se añade " aff=<política>:<cpus>")
+//   (con epi distinto de none se añade " E=<epi> unfused=<s> check=<ok|FAIL|na>":
+//    unfused = multiplicación normal + pasada aparte de bias/relu sobre C;
+//    check compara ambos resultados. Con clamp la pasada aparte solo ve el
+//    valor ya recortado a 32 bits: check compara contra una referencia en
+//    serie desde A y B (int64 + bias, saturación y relu), en todas las filas
+//    si N <= 256 y en ~64 filas repartidas si no)
+//   (con HPC_TLB=1 se añade " pages=<tipo> huge_kb=<kB> dtlb_misses=<n>")
 //
 // Nota: El tiempo medido **excluye** la transposición de B. Solo mide la multiplicación A × B utilizando Bt.
+//
+// A, B, Bt y C salen de una sola arena con huge pages (ver ../common/arena.h);
+// HPC_HUGEPAGES=0 vuelve a páginas de 4KB para comparar.
 
-#define _POSIX_C_SOURCE 200112L
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -19,6 +32,9 @@
 #include <omp.h>
 #include <string.h>
 #include <stdalign.h>
+#include "../common/arena.h"
+#include "../common/affinity.h"
+#include "mm_kernels.h"
 
 static int parse_positive_int(const char *s, int *out) {
     errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
@@ -26,22 +42,10 @@ static int parse_positive_int(const char *s, int *out) {
     *out = (int)v; return 1;
 }
 
-// ---- reserva alineada a 64B (posix_memalign) ----
-static void* aligned_malloc64(size_t bytes) {
-    void *p = NULL;
-    if (posix_memalign(&p, 64, bytes) != 0) return NULL;
-    return p;
-}
-
-// ---- matrices alineadas ----
-static int32_t* alloc_matrix(int n) {
+// ---- matrices alineadas a 64B dentro de la arena (la región nueva ya está en cero) ----
+static int32_t* alloc_matrix(arena_t *ar, int n) {
     size_t bytes = (size_t)n * (size_t)n * sizeof(int32_t);
-    return (int32_t*)aligned_malloc64(bytes);
-}
-static int32_t* alloc_zero_matrix(int n) {
-    int32_t *p = alloc_matrix(n);
-    if (p) memset(p, 0, (size_t)n*(size_t)n*sizeof(int32_t));
-    return p;
+    return (int32_t*)arena_alloc(ar, bytes);
 }
 
 // ---- relleno aleatorio (acotado a 16 bits para reducir overflow acumulado) ----
@@ -51,42 +55,30 @@ static void fill_random_int32(int32_t *M, int n) {
         M[i] = (int32_t)((rand() & 0xFFFF) - 32768); // [-32768, 32767]
 }
 
-// ---- transposición de B a Bt (paralela), fuera del tiempo medido ----
-static void transpose_omp(const int32_t * __restrict B0,
-                          int32_t       * __restrict Bt0, int n)
-{
-    // Afirmar alineación para vectorizador (solo si realmente están alineados)
-    const int32_t *B  = __builtin_assume_aligned(B0,  64);
-    int32_t       *Bt = __builtin_assume_aligned(Bt0, 64);
-
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int i = 0; i < n; ++i)
-        for (int j = 0; j < n; ++j)
-            Bt[(size_t)j*n + (size_t)i] = B[(size_t)i*n + (size_t)j];
-}
-
-// ---- kernel OpenMP usando Bt (accesos contiguos en el bucle interno) ----
-static void matmul_omp_with_Bt(const int32_t * __restrict A0,
-                               const int32_t * __restrict Bt0,
-                               int32_t       * __restrict C0, int n)
-{
-    const int32_t *A  = __builtin_assume_aligned(A0,  64);
-    const int32_t *Bt = __builtin_assume_aligned(Bt0, 64);
-    int32_t       *C  = __builtin_assume_aligned(C0,  64);
-
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < n; ++i) {
-        const int32_t *Ai = &A[(size_t)i*n];
+// ---- referencia del epílogo con clamp: fila i en int64 (i-k-j, lectura lineal
+// de B), + bias, mm_sat32 y después relu. 1 si C coincide, 0 si no, -1 sin memoria ----
+static int check_clamp_ref(const int32_t *A, const int32_t *B, const int32_t *C, int n,
+                           const mm_epilogue_t *ep) {
+    int64_t *acc = (int64_t*)malloc((size_t)n * sizeof(int64_t));
+    if (!acc) return -1;
+    int step = n > 256 ? n / 64 : 1;
+    int ok = 1;
+    for (int i = 0; i < n && ok; i += step) {
+        for (int j = 0; j < n; ++j) acc[j] = 0;
+        for (int k = 0; k < n; ++k) {
+            int64_t a = A[(size_t)i*n + (size_t)k];
+            const int32_t *Bk = &B[(size_t)k*n];
+            for (int j = 0; j < n; ++j) acc[j] += a * (int64_t)Bk[j];
+        }
         for (int j = 0; j < n; ++j) {
-            const int32_t *Btj = &Bt[(size_t)j*n];
-            int64_t acc = 0;
-            // innermost vectorizable, recorrido lineal en Ai[] y Btj[]
-            for (int k = 0; k < n; ++k) {
-                acc += (int64_t)Ai[k] * (int64_t)Btj[k];
-            }
-            C[(size_t)i*n + (size_t)j] = (int32_t)acc; // recorte a 32 bits
+            int64_t v = acc[j] + (ep->bias ? ep->bias[j] : 0);
+            int32_t r = mm_sat32(v);
+            if (ep->relu) r = r < 0 ? 0 : r;
+            if (C[(size_t)i*n + (size_t)j] != r) { ok = 0; break; }
         }
     }
+    free(acc);
+    return ok;
 }
 
 int main(int argc, char **argv) {
@@ -105,40 +97,101 @@ int main(int argc, char **argv) {
         srand((unsigned)time(NULL));
     }
 
+    mm_epilogue_t ep;
+    int want_bias = 0;
+    const char *epi = (argc >= 6) ? argv[5] : "none";
+    if (!mm_epilogue_parse(epi, &ep, &want_bias)) return 5;
+    int use_ep = want_bias || ep.clamp || ep.relu;
+
+    // Contador de dTLB antes de crear hilos (inherit los incluye)
+    tlb_counter_t tlb = { -1 };
+    if (tlb_report_enabled()) tlb_counter_open(&tlb);
+
     omp_set_num_threads(T);
 
-    // Reservas alineadas
-    int32_t *A  = alloc_matrix(N);
-    int32_t *B  = alloc_matrix(N);
-    int32_t *Bt = alloc_matrix(N);
-    int32_t *C  = alloc_zero_matrix(N);
-    if (!A || !B || !Bt || !C) {
-        free(A); free(B); free(Bt); free(C);
+    // Afinidad opcional (HPC_AFFINITY): cada hilo del pool OpenMP se fija una vez;
+    // libgomp reutiliza los mismos hilos en las regiones paralelas siguientes
+    affinity_t aff;
+    if (affinity_from_env(&aff, T)) {
+        #pragma omp parallel
+        affinity_pin_thread(&aff, omp_get_thread_num());
+    }
+
+    // Una sola región para las 4 matrices, prefault paralelo fuera del tiempo medido
+    size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
+    arena_t ar;
+    size_t nmat = use_ep ? 5 : 4;   // + C de la versión sin fusionar
+    size_t row  = arena_round_up((size_t)N * sizeof(int32_t), ARENA_ALIGN);
+    if (!arena_init(&ar, nmat * arena_round_up(bytes, ARENA_ALIGN) + row, 0)) { affinity_release(&aff); return 6; }
+    arena_prefault(&ar, T);
+
+    int32_t *A  = alloc_matrix(&ar, N);
+    int32_t *B  = alloc_matrix(&ar, N);
+    int32_t *Bt = alloc_matrix(&ar, N);
+    int32_t *C  = alloc_matrix(&ar, N);
+    int32_t *C2 = use_ep ? alloc_matrix(&ar, N) : NULL;
+    int32_t *bias = want_bias ? (int32_t*)arena_alloc(&ar, (size_t)N * sizeof(int32_t)) : NULL;
+    if (!A || !B || !Bt || !C || (use_ep && !C2) || (want_bias && !bias)) {
+        arena_destroy(&ar);
+        affinity_release(&aff);
         return 6;
     }
 
     // Inicialización (first-touch paralelo opcional para NUMA)
     fill_random_int32(A, N);
     fill_random_int32(B, N);
+    if (bias) {
+        for (int j = 0; j < N; ++j) bias[j] = (int32_t)((rand() & 0xFFFF) - 32768);
+        ep.bias = bias;
+    }
 
     // Transponer B -> Bt (PARALELO) — NO se cronometra
     transpose_omp(B, Bt, N);
 
     // Medimos SOLO la multiplicación usando Bt
     double t0 = omp_get_wtime();
-    matmul_omp_with_Bt(A, Bt, C, N);
+    tlb_counter_start(&tlb);
+    matmul_omp_with_Bt_ep(A, Bt, C, N, &ep);
+    tlb_counter_stop(&tlb);
     double t1 = omp_get_wtime();
     double elapsed = t1 - t0;
 
+    // Referencia sin fusionar: multiplicación + pasada aparte sobre C
+    double unfused = 0.0;
+    const char *check = "na";
+    if (use_ep) {
+        double u0 = omp_get_wtime();
+        matmul_omp_with_Bt(A, Bt, C2, N);
+        mm_epilogue_pass(C2, N, &ep);
+        unfused = omp_get_wtime() - u0;
+        if (!ep.clamp) {
+            check = memcmp(C, C2, bytes) == 0 ? "ok" : "FAIL";
+        } else {
+            int r = check_clamp_ref(A, B, C, N, &ep);
+            check = r < 0 ? "na" : (r ? "ok" : "FAIL");
+        }
+    }
+
     // Guardar tiempo en archivo
     FILE *f = fopen(outfile, "a");
     if (!f) {
-        free(A); free(B); free(Bt); free(C);
+        arena_destroy(&ar);
+        affinity_release(&aff);
+        tlb_counter_close(&tlb);
         return 7;
     }
-    fprintf(f, "N=%d T=%d K=Bt %.6f\n", N, T, elapsed);
+    fprintf(f, "N=%d T=%d K=Bt %.6f", N, T, elapsed);
+    if (use_ep) fprintf(f, " E=%s unfused=%.6f check=%s", epi, unfused, check);
+    if (aff.enabled) {
+        char buf[512];
+        fprintf(f, " aff=%s", affinity_format(&aff, buf, sizeof buf, ','));
+    }
+    if (tlb_report_enabled()) arena_report(f, &ar, &tlb);
+    fprintf(f, "\n");
     fclose(f);
 
-    free(A); free(B); free(Bt); free(C);
+    arena_destroy(&ar);
+    affinity_release(&aff);
+    tlb_counter_close(&tlb);
     return 0;
 }
\ No newline at end of file
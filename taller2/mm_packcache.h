@@ -0,0 +1,234 @@
+// mm_packcache.h — caché de B ya transpuesta (Bt) para multiplicaciones repetidas
+//
+// Caso típico: B es una matriz de pesos fija y se multiplica por muchas A
+// distintas. En vez de transponer B en cada llamada, se guarda Bt residente:
+//   clave   = (puntero de B, n, tag) + hash de contenido (si verify != 0)
+//             tag lo elige el llamador (p. ej. generación del mapeo en mm_server)
+//             para que un buffer nuevo en la misma dirección no choque; 0 si no aplica
+//   memoria = presupuesto en bytes, reservado y fallado UNA vez en
+//             packcache_init (arena.h, huge pages si hay, arena_prefault con
+//             T hilos). Cada Bt es un trozo de esa región: primer hueco que
+//             cabe, y al liberar los huecos vecinos se juntan. Si no cabe
+//             (presupuesto o fragmentación) se expulsa la entrada menos
+//             recientemente usada (LRU) hasta que haya hueco. Un fallo de
+//             caché solo transpone: ni posix_memalign ni fallos de página
+//             dentro del tiempo medido
+//
+// Con verify = 0 se confía en la identidad del buffer (el llamador garantiza
+// que B no cambió); con verify = 1 cada get relee B entera para el hash
+// (packcache_hash: una pasada lineal por palabras de 64 bits, una suma y un
+// producto por palabra, vectorizable). Es más barato que transponer
+// (escrituras con stride n) pero sigue siendo O(n^2) por llamada: solo
+// verify = 0 (MM_F_B_STABLE en mm_server) se lo ahorra del todo.
+//
+// El puntero devuelto por packcache_get_Bt es válido hasta la siguiente
+// llamada que pueda expulsar (otra get) o packcache_destroy. Un Bt más grande
+// que el presupuesto no se puede servir (NULL): mm_server lo dimensiona para
+// max_N.
+//
+// Requiere _GNU_SOURCE antes de cualquier #include (arena.h).
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "../common/arena.h"
+#include "mm_kernels.h"
+
+typedef struct pc_entry {
+    const int32_t *src;      // B original (identidad)
+    int n;
+    uint64_t tag;            // identidad extra del llamador
+    uint64_t hash;           // hash de contenido al empaquetar
+    int32_t *Bt;             // forma empaquetada (transpuesta), trozo de la región
+    size_t bytes;            // tamaño del trozo (múltiplo de ARENA_ALIGN)
+    struct pc_entry *prev, *next;   // lista LRU: head = más reciente
+} pc_entry_t;
+
+// Hueco de la región; lista ordenada por desplazamiento
+typedef struct pc_hole {
+    size_t off, size;
+    struct pc_hole *next;
+} pc_hole_t;
+
+typedef struct {
+    size_t budget, used;     // bytes
+    int verify;              // 1: comprobar hash de contenido en cada get
+    arena_t ar;              // región de budget bytes, ya fallada
+    unsigned char *base;
+    pc_hole_t *holes;
+    pc_entry_t *head, *tail;
+    long hits, misses, evictions;
+} packcache_t;
+
+// Reserva y falla la región con T hilos. 1 bien, 0 sin memoria.
+static inline int packcache_init(packcache_t *pc, size_t budget_bytes, int verify, int T) {
+    memset(pc, 0, sizeof(*pc));
+    pc->budget = arena_round_up(budget_bytes ? budget_bytes : 1, ARENA_ALIGN);
+    pc->verify = verify;
+    if (!arena_init(&pc->ar, pc->budget, 0)) return 0;
+    arena_prefault(&pc->ar, T);
+    pc->base = (unsigned char*)arena_alloc(&pc->ar, pc->budget);
+    pc->holes = (pc_hole_t*)malloc(sizeof(*pc->holes));
+    if (!pc->base || !pc->holes) {
+        free(pc->holes);
+        arena_destroy(&pc->ar);
+        return 0;
+    }
+    pc->holes->off = 0;
+    pc->holes->size = pc->budget;
+    pc->holes->next = NULL;
+    return 1;
+}
+
+// Primer hueco donde caben `bytes`; NULL si ninguno
+static inline int32_t* pc_region_alloc(packcache_t *pc, size_t bytes) {
+    for (pc_hole_t **pp = &pc->holes; *pp; pp = &(*pp)->next) {
+        pc_hole_t *h = *pp;
+        if (h->size < bytes) continue;
+        size_t off = h->off;
+        h->off += bytes;
+        h->size -= bytes;
+        if (h->size == 0) { *pp = h->next; free(h); }
+        return (int32_t*)(pc->base + off);
+    }
+    return NULL;
+}
+
+// Devuelve el trozo a la lista y lo junta con los huecos vecinos
+static inline void pc_region_free(packcache_t *pc, const void *p, size_t bytes) {
+    size_t off = (size_t)((const unsigned char*)p - pc->base);
+    pc_hole_t *prev = NULL, *next = pc->holes;
+    while (next && next->off < off) { prev = next; next = next->next; }
+    int join_prev = prev && prev->off + prev->size == off;
+    int join_next = next && off + bytes == next->off;
+    if (join_prev && join_next) {
+        prev->size += bytes + next->size;
+        prev->next = next->next;
+        free(next);
+    } else if (join_prev) {
+        prev->size += bytes;
+    } else if (join_next) {
+        next->off = off;
+        next->size += bytes;
+    } else {
+        pc_hole_t *h = (pc_hole_t*)malloc(sizeof(*h));
+        if (!h) return;   // sin memoria para el nodo: el hueco se pierde
+        h->off = off;
+        h->size = bytes;
+        h->next = next;
+        if (prev) prev->next = h; else pc->holes = h;
+    }
+}
+
+// Hash de contenido paralelo: suma de mezclas (valor, índice) -> no depende
+// del reparto entre hilos y detecta permutaciones.
+static inline uint64_t pc_mix(uint64_t x) {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+// Hash de contenido: B leída como palabras de 64 bits (pares de int32),
+// s = suma y t = suma ponderada por pesos impares según la posición (detecta
+// cualquier palabra cambiada y los intercambios de lugar). Sin mezcla pesada
+// por elemento: pc_mix solo se aplica una vez al final.
+static inline uint64_t packcache_hash(const int32_t *B0, int n) {
+    const int32_t *B = __builtin_assume_aligned(B0, 64);
+    size_t nn = (size_t)n * (size_t)n;
+    size_t nw = nn / 2;
+    uint64_t s = 0, t = 0;
+    #pragma omp parallel for schedule(static) reduction(+:s,t)
+    for (size_t i = 0; i < nw; ++i) {
+        uint64_t w;
+        memcpy(&w, &B[2*i], sizeof w);
+        s += w;
+        t += w * (2*(uint64_t)i + 1);
+    }
+    if (nn & 1) s += (uint32_t)B[nn - 1];
+    return pc_mix(s ^ pc_mix(t ^ (uint64_t)n));
+}
+
+static inline void pc_unlink(packcache_t *pc, pc_entry_t *e) {
+    if (e->prev) e->prev->next = e->next; else pc->head = e->next;
+    if (e->next) e->next->prev = e->prev; else pc->tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static inline void pc_push_front(packcache_t *pc, pc_entry_t *e) {
+    e->prev = NULL;
+    e->next = pc->head;
+    if (pc->head) pc->head->prev = e;
+    pc->head = e;
+    if (!pc->tail) pc->tail = e;
+}
+
+static inline void pc_free_entry(packcache_t *pc, pc_entry_t *e) {
+    pc_unlink(pc, e);
+    pc->used -= e->bytes;
+    pc_region_free(pc, e->Bt, e->bytes);
+    free(e);
+}
+
+// Devuelve Bt para B (empaquetando solo si no está en caché). NULL si no hay memoria.
+// verify_this = 0 salta el hash en esta llamada aunque pc->verify esté activo.
+static inline const int32_t* packcache_get_Bt(packcache_t *pc, const int32_t *B, int n,
+                                              uint64_t tag, int verify_this) {
+    int verify = pc->verify && verify_this;
+    uint64_t h = verify ? packcache_hash(B, n) : 0;
+
+    for (pc_entry_t *e = pc->head; e; e = e->next) {
+        if (e->src != B || e->n != n || e->tag != tag) continue;
+        if (verify && e->hash != h) {   // mismo buffer, contenido nuevo
+            pc_free_entry(pc, e);
+            break;
+        }
+        pc_unlink(pc, e);
+        pc_push_front(pc, e);
+        pc->hits++;
+        return e->Bt;
+    }
+
+    pc->misses++;
+    size_t bytes = arena_round_up((size_t)n * (size_t)n * sizeof(int32_t), ARENA_ALIGN);
+    if (bytes > pc->budget) return NULL;
+    while (pc->tail && pc->used + bytes > pc->budget) {
+        pc_free_entry(pc, pc->tail);
+        pc->evictions++;
+    }
+    int32_t *p = pc_region_alloc(pc, bytes);
+    while (!p && pc->tail) {   // cabe en el presupuesto pero no en un hueco
+        pc_free_entry(pc, pc->tail);
+        pc->evictions++;
+        p = pc_region_alloc(pc, bytes);
+    }
+
+    pc_entry_t *e = (pc_entry_t*)calloc(1, sizeof(*e));
+    if (!e || !p) {
+        free(e);
+        if (p) pc_region_free(pc, p, bytes);
+        return NULL;
+    }
+    e->src = B; e->n = n; e->tag = tag;
+    // se guarda el hash aunque esta llamada no verificara, para las siguientes
+    e->hash = verify ? h : (pc->verify ? packcache_hash(B, n) : 0);
+    e->Bt = p;
+    e->bytes = bytes;
+    transpose_omp(B, e->Bt, n);
+
+    pc->used += bytes;
+    pc_push_front(pc, e);
+    return e->Bt;
+}
+
+static inline void packcache_destroy(packcache_t *pc) {
+    while (pc->head) pc_free_entry(pc, pc->head);
+    while (pc->holes) {
+        pc_hole_t *h = pc->holes;
+        pc->holes = h->next;
+        free(h);
+    }
+    arena_destroy(&pc->ar);
+    memset(pc, 0, sizeof(*pc));
+}
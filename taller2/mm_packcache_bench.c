@@ -0,0 +1,128 @@
+// mm_packcache_bench.c — ganancia amortizada de la caché de Bt (mm_packcache.h)
+//
+// Secuencia de M multiplicaciones C = A_k × B con B fija y A_k distinta en
+// cada paso (regenerada fuera del tiempo medido). Se mide el total de:
+//   nocache       transponer B + multiplicar en cada paso (mm_omp_opt_mem)
+//   cache         packcache_get_Bt (identidad del buffer) + multiplicar
+//   cache_verify  igual, pero comprobando el hash de contenido de B cada vez
+//
+// Compilar:
+//   gcc -O3 -std=c11 -march=native -fopenmp mm_packcache_bench.c -o mm_packcache_bench
+// Args:
+//   1) N        (tamaño de la matriz cuadrada, obligatorio)
+//   2) M        (multiplicaciones por secuencia, obligatorio)
+//   3) T        (hilos OpenMP, obligatorio)
+//   4) outfile  (obligatorio)
+//   5) [seed]   (opcional; si no se da, usa time(NULL))
+//
+// Salida (append), una línea por corrida (tiempos totales en segundos):
+//   N=<N> T=<T> M=<M> nocache=<s> cache=<s> cache_verify=<s> per_mult_nocache=<s> per_mult_cache=<s> hits=<h> check=<ok|FAIL>
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <omp.h>
+#include "../common/arena.h"
+#include "mm_kernels.h"
+#include "mm_packcache.h"
+
+static int parse_positive_int(const char *s, int *out) {
+    errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
+    if (errno || e == s || *e != '\0' || v <= 0 || v > INT_MAX) return 0;
+    *out = (int)v; return 1;
+}
+
+static void fill_random_int32(int32_t *M, int n) {
+    size_t nn = (size_t)n * (size_t)n;
+    for (size_t i = 0; i < nn; ++i)
+        M[i] = (int32_t)((rand() & 0xFFFF) - 32768); // [-32768, 32767]
+}
+
+// A_k distinta por paso: relleno paralelo barato a partir de k (fuera del tiempo)
+static void fill_step(int32_t *A, int n, int k) {
+    size_t nn = (size_t)n * (size_t)n;
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < nn; ++i)
+        A[i] = (int32_t)((pc_mix((uint64_t)i * 0x9e3779b97f4a7c15ULL + (uint64_t)k) & 0xFFFF) - 32768);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5) return 2;
+
+    int N = 0, M = 0, T = 0;
+    if (!parse_positive_int(argv[1], &N)) return 3;
+    if (!parse_positive_int(argv[2], &M)) return 3;
+    if (!parse_positive_int(argv[3], &T)) return 3;
+    const char *outfile = argv[4];
+
+    if (argc >= 6) {
+        int seed = 0;
+        if (!parse_positive_int(argv[5], &seed)) return 4;
+        srand((unsigned)seed);
+    } else {
+        srand((unsigned)time(NULL));
+    }
+
+    omp_set_num_threads(T);
+
+    size_t bytes = (size_t)N * (size_t)N * sizeof(int32_t);
+    arena_t ar;
+    if (!arena_init(&ar, 4 * arena_round_up(bytes, ARENA_ALIGN), 0)) return 6;
+    arena_prefault(&ar, T);
+    int32_t *A  = (int32_t*)arena_alloc(&ar, bytes);
+    int32_t *B  = (int32_t*)arena_alloc(&ar, bytes);
+    int32_t *Bt = (int32_t*)arena_alloc(&ar, bytes);
+    int32_t *C  = (int32_t*)arena_alloc(&ar, bytes);
+    int32_t *C_ref = (int32_t*)malloc(bytes);
+    if (!A || !B || !Bt || !C || !C_ref) { free(C_ref); arena_destroy(&ar); return 6; }
+
+    fill_random_int32(B, N);
+
+    // ---- sin caché: transponer en cada paso ----
+    double t_nocache = 0.0;
+    for (int k = 0; k < M; ++k) {
+        fill_step(A, N, k);
+        double t0 = omp_get_wtime();
+        transpose_omp(B, Bt, N);
+        matmul_omp_with_Bt(A, Bt, C, N);
+        t_nocache += omp_get_wtime() - t0;
+    }
+    memcpy(C_ref, C, bytes);
+
+    // ---- con caché (identidad del buffer / hash de contenido) ----
+    double t_cache[2] = { 0.0, 0.0 };
+    long hits = 0;
+    int ok = 1;
+    for (int verify = 0; verify <= 1; ++verify) {
+        packcache_t pc;
+        if (!packcache_init(&pc, 2 * bytes, verify, T)) { free(C_ref); arena_destroy(&ar); return 6; }
+        for (int k = 0; k < M; ++k) {
+            fill_step(A, N, k);
+            double t0 = omp_get_wtime();
+            const int32_t *P = packcache_get_Bt(&pc, B, N, 0, 1);
+            if (!P) { packcache_destroy(&pc); free(C_ref); arena_destroy(&ar); return 6; }
+            matmul_omp_with_Bt(A, P, C, N);
+            t_cache[verify] += omp_get_wtime() - t0;
+        }
+        if (memcmp(C, C_ref, bytes) != 0) ok = 0;
+        if (!verify) hits = pc.hits;
+        packcache_destroy(&pc);
+    }
+
+    FILE *f = fopen(outfile, "a");
+    if (!f) { free(C_ref); arena_destroy(&ar); return 7; }
+    fprintf(f, "N=%d T=%d M=%d nocache=%.6f cache=%.6f cache_verify=%.6f "
+               "per_mult_nocache=%.6f per_mult_cache=%.6f hits=%ld check=%s\n",
+            N, T, M, t_nocache, t_cache[0], t_cache[1],
+            t_nocache / M, t_cache[0] / M, hits, ok ? "ok" : "FAIL");
+    fclose(f);
+
+    free(C_ref);
+    arena_destroy(&ar);
+    return ok ? 0 : 10;
+}
@@ -0,0 +1,302 @@
+// mm_server.c — servicio persistente de multiplicación de matrices int32
+//
+// Evita pagar en cada llamada exec + reservas + creación de hilos: el proceso
+// queda vivo con el pool OpenMP caliente y la región de los Bt ya fallada
+// (arena con huge pages), y recibe trabajos por un socket Unix con las matrices
+// en un memfd compartido con el cliente (sin copias). Protocolo en mm_service.h.
+//
+// Pipeline: un hilo de intake por conexión recibe la petición, mapea el memfd
+// (MAP_POPULATE) y encola; el hilo principal solo calcula. Mientras se
+// multiplica el trabajo k, el intake del k+1 ya está hecho.
+//
+// Bt se guarda en una caché LRU (mm_packcache.h) con presupuesto cache_MB,
+// reservado y fallado al arrancar: si un cliente vuelve a mandar la misma B se
+// salta la transposición, y si no, el Bt nuevo reusa páginas ya falladas.
+//
+// Las peticiones pueden pedir epílogo fusionado con MM_F_CLAMP / MM_F_RELU.
+//
+// Compilar:
+//   gcc -O3 -std=c11 -march=native -fopenmp -pthread mm_server.c -o mm_server
+// Ejecutar:
+//   ./mm_server [T] [max_N] [socket] [cache_MB]
+//   (por defecto: nproc, 4096, /tmp/mm_service.sock, 256)
+//
+// Cliente de línea de comandos: mm_client.c; generador de carga: mm_loadgen.c.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "../common/affinity.h"
+#include "mm_kernels.h"
+#include "mm_service.h"
+#include "mm_packcache.h"
+
+#define QCAP 64   // trabajos en cola como máximo (backpressure sobre el intake)
+
+static int parse_positive_int(const char *s, int *out) {
+    errno = 0; char *e = NULL; long v = strtol(s, &e, 10);
+    if (errno || e == s || *e != '\0' || v <= 0 || v > INT_MAX) return 0;
+    *out = (int)v; return 1;
+}
+
+// -------------------- Conexión --------------------
+typedef struct {
+    int sock;
+    pthread_mutex_t mu;     // protege pending y las escrituras al socket
+    pthread_cond_t  idle;   // pending llegó a 0
+    int pending;            // trabajos de esta conexión en cola o calculándose
+    // mapeo cacheado del último memfd recibido
+    dev_t dev; ino_t ino;
+    unsigned char *map; size_t map_bytes;
+    uint64_t map_gen;       // generación del mapeo: tag de la caché de Bt
+} conn_t;
+
+typedef struct {
+    conn_t *c;
+    mm_req_t req;
+    const int32_t *A, *B;
+    int32_t *C;
+    uint64_t tag;
+    double t_in;
+} job_t;
+
+// -------------------- Cola FIFO acotada --------------------
+static struct {
+    job_t buf[QCAP];
+    int head, count;
+    pthread_mutex_t mu;
+    pthread_cond_t not_empty, not_full;
+} q = { .mu = PTHREAD_MUTEX_INITIALIZER,
+        .not_empty = PTHREAD_COND_INITIALIZER,
+        .not_full = PTHREAD_COND_INITIALIZER };
+
+static void q_push(const job_t *j) {
+    pthread_mutex_lock(&q.mu);
+    while (q.count == QCAP) pthread_cond_wait(&q.not_full, &q.mu);
+    q.buf[(q.head + q.count) % QCAP] = *j;
+    q.count++;
+    pthread_cond_signal(&q.not_empty);
+    pthread_mutex_unlock(&q.mu);
+}
+
+static void q_pop(job_t *j) {
+    pthread_mutex_lock(&q.mu);
+    while (q.count == 0) pthread_cond_wait(&q.not_empty, &q.mu);
+    *j = q.buf[q.head];
+    q.head = (q.head + 1) % QCAP;
+    q.count--;
+    pthread_cond_signal(&q.not_full);
+    pthread_mutex_unlock(&q.mu);
+}
+
+// -------------------- Estado global del servidor --------------------
+static int g_max_n = 4096;
+static uint64_t g_map_gen = 0;   // solo lo tocan los intake bajo g_gen_mu
+static pthread_mutex_t g_gen_mu = PTHREAD_MUTEX_INITIALIZER;
+static const char *g_sock_path = MM_SOCK_DEFAULT;
+
+static inline double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void conn_reply(conn_t *c, const mm_resp_t *r) {
+    pthread_mutex_lock(&c->mu);
+    mm_write_all(c->sock, r, sizeof(*r));   // si el cliente se fue, el intake lo verá
+    pthread_mutex_unlock(&c->mu);
+}
+
+static void conn_wait_idle(conn_t *c) {
+    pthread_mutex_lock(&c->mu);
+    while (c->pending > 0) pthread_cond_wait(&c->idle, &c->mu);
+    pthread_mutex_unlock(&c->mu);
+}
+
+// Ajusta el mapeo de la conexión al memfd recibido. Devuelve MM_OK o un error.
+static int conn_map(conn_t *c, int memfd, int n) {
+    size_t need = mm_job_bytes(n);
+    if (memfd < 0)
+        return (c->map && c->map_bytes >= need) ? MM_OK : MM_EBADREQ;
+
+    // sin F_SEAL_SHRINK el cliente podría encoger el memfd con el mapeo vivo
+    // (SIGBUS en el servidor): se rechaza
+    int seals = fcntl(memfd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) { close(memfd); return MM_EMAP; }
+
+    struct stat st;
+    if (fstat(memfd, &st) != 0 || (size_t)st.st_size < need) { close(memfd); return MM_EMAP; }
+
+    // mismo memfd que la vez anterior: se reutiliza el mapeo (páginas ya falladas)
+    if (c->map && st.st_dev == c->dev && st.st_ino == c->ino && c->map_bytes >= need) {
+        close(memfd);
+        return MM_OK;
+    }
+
+    // buffer nuevo: esperar a que no haya trabajos usando el mapeo anterior
+    conn_wait_idle(c);
+    if (c->map) munmap(c->map, c->map_bytes);
+    c->map = NULL;
+
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, memfd, 0);
+    close(memfd);
+    if (p == MAP_FAILED) return MM_EMAP;
+    c->map = (unsigned char*)p;
+    c->map_bytes = (size_t)st.st_size;
+    c->dev = st.st_dev;
+    c->ino = st.st_ino;
+    pthread_mutex_lock(&g_gen_mu);
+    c->map_gen = ++g_map_gen;
+    pthread_mutex_unlock(&g_gen_mu);
+    return MM_OK;
+}
+
+// -------------------- Intake (un hilo por conexión) --------------------
+static void* intake_run(void *arg) {
+    conn_t *c = (conn_t*)arg;
+    mm_req_t req;
+    int memfd;
+
+    while (mm_recv_req(c->sock, &req, &memfd)) {
+        int st = MM_OK;
+        if (req.magic != MM_MAGIC || req.n <= 0) st = MM_EBADREQ;
+        else if (req.n > g_max_n)                st = MM_ETOOBIG;
+
+        if (st == MM_OK) st = conn_map(c, memfd, req.n);
+        else if (memfd >= 0) close(memfd);
+
+        if (st != MM_OK) {
+            mm_resp_t r = { MM_MAGIC, st, req.id, 0.0, 0.0, 0, 0 };
+            conn_reply(c, &r);
+            continue;
+        }
+
+        size_t S = mm_job_stride(req.n);
+        job_t j = { c, req,
+                    (const int32_t*)c->map, (const int32_t*)(c->map + S),
+                    (int32_t*)(c->map + 2 * S), c->map_gen, now_sec() };
+        pthread_mutex_lock(&c->mu);
+        c->pending++;
+        pthread_mutex_unlock(&c->mu);
+        q_push(&j);
+    }
+
+    // EOF: liberar cuando el último trabajo de esta conexión haya contestado
+    conn_wait_idle(c);
+    if (c->map) munmap(c->map, c->map_bytes);
+    close(c->sock);
+    pthread_mutex_destroy(&c->mu);
+    pthread_cond_destroy(&c->idle);
+    free(c);
+    return NULL;
+}
+
+static void* accept_run(void *arg) {
+    int lsock = *(int*)arg;
+    for (;;) {
+        int s = accept4(lsock, NULL, NULL, SOCK_CLOEXEC);
+        if (s < 0) { if (errno == EINTR) continue; perror("accept"); continue; }
+        conn_t *c = (conn_t*)calloc(1, sizeof(*c));
+        if (!c) { close(s); continue; }
+        c->sock = s;
+        pthread_mutex_init(&c->mu, NULL);
+        pthread_cond_init(&c->idle, NULL);
+        pthread_t th;
+        if (pthread_create(&th, NULL, intake_run, c) != 0) {
+            close(s); free(c); continue;
+        }
+        pthread_detach(th);
+    }
+    return NULL;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    unlink(g_sock_path);
+    _exit(0);
+}
+
+// -------------------- main: cómputo --------------------
+int main(int argc, char **argv) {
+    int T = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 1 && !parse_positive_int(argv[1], &T)) return 3;
+    if (argc > 2 && !parse_positive_int(argv[2], &g_max_n)) return 3;
+    if (argc > 3) g_sock_path = argv[3];
+    int cache_mb = 256;
+    if (argc > 4 && !parse_positive_int(argv[4], &cache_mb)) return 3;
+
+    omp_set_num_threads(T);
+
+    // Pool OpenMP caliente (y fijado si HPC_AFFINITY) antes del primer trabajo
+    affinity_t aff;
+    affinity_from_env(&aff, T);
+    #pragma omp parallel
+    affinity_pin_thread(&aff, omp_get_thread_num());
+
+    // Caché de Bt (verifica contenido salvo MM_F_B_STABLE); un Bt de max_N
+    // cabe siempre. La región se falla aquí, no en el primer trabajo
+    packcache_t pc;
+    size_t bt_max = (size_t)g_max_n * (size_t)g_max_n * sizeof(int32_t);
+    size_t budget = (size_t)cache_mb << 20;
+    if (!packcache_init(&pc, budget > bt_max ? budget : bt_max, 1, T)) {
+        perror("packcache"); return 6;
+    }
+
+    int lsock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (lsock < 0) { perror("socket"); return 7; }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, g_sock_path, sizeof(addr.sun_path) - 1);
+    unlink(g_sock_path);
+    if (bind(lsock, (struct sockaddr*)&addr, sizeof addr) != 0 || listen(lsock, 64) != 0) {
+        perror("bind/listen"); return 7;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    pthread_t acc;
+    if (pthread_create(&acc, NULL, accept_run, &lsock) != 0) { perror("pthread_create"); return 7; }
+
+    char abuf[512];
+    fprintf(stderr, "mm_server: T=%d max_N=%d socket=%s cache_MB=%d pages=%s aff=%s\n",
+            T, g_max_n, g_sock_path, cache_mb, arena_kind_name(&pc.ar),
+            affinity_format(&aff, abuf, sizeof abuf, ','));
+
+    for (;;) {
+        job_t j;
+        q_pop(&j);
+        double t0 = now_sec();
+        long hits0 = pc.hits;
+        const int32_t *Bt = packcache_get_Bt(&pc, j.B, j.req.n, j.tag,
+                                             !(j.req.flags & MM_F_B_STABLE));
+        int st = MM_EMAP;
+        if (Bt) {
+            mm_epilogue_t ep = { NULL, !!(j.req.flags & MM_F_CLAMP),
+                                 !!(j.req.flags & MM_F_RELU) };
+            matmul_omp_with_Bt_ep(j.A, Bt, j.C, j.req.n, &ep);
+            st = MM_OK;
+        }
+        double t1 = now_sec();
+
+        mm_resp_t r = { MM_MAGIC, st, j.req.id, t0 - j.t_in, t1 - t0,
+                        (int32_t)(pc.hits - hits0), 0 };
+        conn_reply(j.c, &r);
+
+        pthread_mutex_lock(&j.c->mu);
+        if (--j.c->pending == 0) pthread_cond_broadcast(&j.c->idle);
+        pthread_mutex_unlock(&j.c->mu);
+    }
+    return 0;
+}
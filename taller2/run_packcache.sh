@@ -0,0 +1,31 @@
+#!/bin/bash
+set -euo pipefail
+
+# Ganancia amortizada de la caché de Bt (mm_packcache_bench):
+# M multiplicaciones con la misma B y A distintas, con y sin caché.
+
+# ================= CONFIGURACIÓN =================
+EXE="./mm_packcache_bench"
+T=4
+NS=(512 1024 2048)
+MS=(1 4 16)
+REPS=5
+SEED=12345
+
+OUT_DIR="resultados_packcache"
+mkdir -p "$OUT_DIR"
+OUT="$OUT_DIR/packcache.txt"
+: > "$OUT"
+# =================================================
+
+for rep in $(seq 1 "$REPS"); do
+  echo "  Repetición $rep..."
+  for n in "${NS[@]}"; do
+    for m in "${MS[@]}"; do
+      echo "    N=$n M=$m"
+      "$EXE" "$n" "$m" "$T" "$OUT" "$SEED"
+    done
+  done
+done
+
+echo ">>> Resultados en: $OUT"
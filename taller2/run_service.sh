@@ -0,0 +1,43 @@
+#!/bin/bash
+set -euo pipefail
+
+# Throughput/latencia del servicio persistente (mm_server) con mm_loadgen.
+# Como referencia, también mide J lanzamientos de ./mm_omp_opt_mem_O3
+# (exec + reservas + relleno + hilos en cada llamada).
+
+# ================= CONFIGURACIÓN =================
+T=4
+NS=(256 512 1024)
+JOBS=100
+CONC=(1 2 4)
+SOCK="/tmp/mm_service_bench.sock"
+
+OUT_DIR="resultados_service"
+mkdir -p "$OUT_DIR"
+OUT="$OUT_DIR/loadgen.txt"
+BASE="$OUT_DIR/exec_por_llamada.txt"
+: > "$OUT"; : > "$BASE"
+# =================================================
+
+max_n=$(printf '%s\n' "${NS[@]}" | sort -n | tail -1)
+./mm_server "$T" "$max_n" "$SOCK" &
+SRV=$!
+trap 'kill $SRV 2>/dev/null || true' EXIT
+sleep 1
+
+for n in "${NS[@]}"; do
+  for c in "${CONC[@]}"; do
+    echo ">>> loadgen N=$n J=$JOBS C=$c"
+    ./mm_loadgen "$n" "$JOBS" "$c" "$OUT" "$SOCK"
+  done
+
+  echo ">>> exec por llamada N=$n J=$JOBS"
+  t0=$(date +%s.%N)
+  for j in $(seq 1 "$JOBS"); do
+    ./mm_omp_opt_mem_O3 "$n" "$T" /dev/null "$j"
+  done
+  t1=$(date +%s.%N)
+  echo "N=$n J=$JOBS wall=$(echo "$t1 - $t0" | bc)" >> "$BASE"
+done
+
+echo ">>> Resultados en: $OUT y $BASE"
@@ -0,0 +1,35 @@
+#!/bin/bash
+set -euo pipefail
+
+# Compara páginas de 4KB contra huge pages (arena de ../common/arena.h)
+# midiendo fallos de dTLB durante la multiplicación (HPC_TLB=1).
+# Si la VM no expone contadores, la columna sale como "na".
+
+# ================= CONFIGURACIÓN =================
+EXES=( "./mm_omp_O3" "./mm_omp_opt_mem_O3" )
+NAMES=( "mm_omp" "mm_omp_opt_mem" )
+T=4
+NS=(1024 2048 4096)
+REPS=3
+SEED=12345
+
+OUT_DIR="resultados_tlb"
+mkdir -p "$OUT_DIR"
+# =================================================
+
+for i in "${!EXES[@]}"; do
+  exe="${EXES[$i]}"
+  name="${NAMES[$i]}"
+  out_file="$OUT_DIR/tlb_${name}.txt"
+  : > "$out_file"
+
+  echo ">>> Versión: $name ($exe)"
+  for rep in $(seq 1 "$REPS"); do
+    for n in "${NS[@]}"; do
+      echo "    N=$n  4k vs huge..."
+      HPC_TLB=1 HPC_HUGEPAGES=0 "$exe" "$n" "$T" "$out_file" "$SEED"
+      HPC_TLB=1                 "$exe" "$n" "$T" "$out_file" "$SEED"
+    done
+  done
+  echo ">>> Resultados en: $out_file"
+done